@@ -0,0 +1,48 @@
+const os = require('os');
+const keysGenerator = require('./index.js');
+
+// Usage: node bench.js [keyLength] [keysPerThread]
+const keyLength = parseInt(process.argv[2], 10) || 2048;
+const keysPerThread = parseInt(process.argv[3], 10) || (keyLength > 2048 ? 2 : 8);
+
+// 1, 2, 4, ... threads up to the core count
+const cores = os.cpus().length;
+const threadCounts = [];
+for (let threads = 1; threads < cores; threads *= 2) {
+    threadCounts.push(threads);
+}
+threadCounts.push(cores);
+
+async function run(isolated, threads) {
+    keysGenerator.configure({ isolatedCryptoContexts: isolated });
+    const result = await keysGenerator.generateKeysBatch(threads * keysPerThread, keyLength, {
+        concurrency: threads,
+        chunkSize: threads * keysPerThread,
+        onChunk: () => {}
+    });
+    return result.keysPerSecond;
+}
+
+(async () => {
+    console.log('Node RSA Keys Generator Benchmark');
+    console.log('=================================');
+    console.log(`Batch keygen, ${keyLength}-bit keys, ${keysPerThread} keys per thread, ${cores} cores\n`);
+
+    // Warm up both modes so one-time OpenSSL initialization is not measured
+    await run(false, 1);
+    await run(true, 1);
+
+    console.log('threads   shared keys/s   isolated keys/s   isolated/shared');
+    for (const threads of threadCounts) {
+        const shared = await run(false, threads);
+        const isolated = await run(true, threads);
+        console.log(
+            String(threads).padEnd(10) +
+            shared.toFixed(1).padStart(13) +
+            isolated.toFixed(1).padStart(18) +
+            (isolated / shared).toFixed(2).padStart(18));
+    }
+
+    keysGenerator.configure({ isolatedCryptoContexts: false });
+    console.log('\nBenchmark completed!');
+})();
\ No newline at end of file
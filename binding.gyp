@@ -6,7 +6,17 @@
         "src/napi_wrapper.cpp",
         "src/platform_utils.cpp",
         "src/keyring.cpp",
-        "src/rsa_generator.cpp"
+        "src/keyring_executor.cpp",
+        "src/kernel_keyring.cpp",
+        "src/memory_keyring.cpp",
+        "src/file_keystore.cpp",
+        "src/deadline_timer.cpp",
+        "src/keyring_cache.cpp",
+        "src/rsa_generator.cpp",
+        "src/key_pool.cpp",
+        "src/write_behind.cpp",
+        "src/thread_pool.cpp",
+        "src/process_lock.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
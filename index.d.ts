@@ -57,12 +57,392 @@ export function getPlatform(): "Windows" | "Linux" | "macOS" | "Unknown";
 export function regenerateKeys(serviceName: string, keyLength?: number): string | null;
 
 /**
- * Clear stored keys from the system keychain.
- * Note: This functionality is not implemented in the current version.
+ * Options accepted by the async API.
+ */
+export interface AsyncCallOptions {
+    /**
+     * Stops the native work and rejects the promise with the signal's reason when aborted.
+     * Calls that change stored keys reject only if aborted before they changed anything;
+     * aborted later, they settle with their result.
+     */
+    signal?: AbortSignal;
+}
+
+/**
+ * Async variant of generateKeys. Key generation and keychain I/O run on the
+ * libuv thread pool, so the event loop is not blocked.
+ *
+ * @param serviceName - Service name prefix for keychain storage (required)
+ * @param keyLength - RSA key length in bits (default: from RSA_KEY_LENGTH env var or 2048)
+ * @param options - Call options, e.g. an AbortSignal
+ * @returns Resolves with the public key in PEM format, or null if generation fails
+ */
+export function generateKeysAsync(serviceName: string, keyLength?: number, options?: AsyncCallOptions): Promise<string | null>;
+
+/**
+ * Async variant of getPublicKey. The keychain lookup runs off the event loop.
+ *
+ * @param serviceName - Service name prefix for keychain storage (required)
+ * @param options - Call options, e.g. an AbortSignal
+ * @returns Resolves with the stored public key in PEM format, or null if not found
+ */
+export function getPublicKeyAsync(serviceName: string, options?: AsyncCallOptions): Promise<string | null>;
+
+/**
+ * Async variant of getPrivateKey. The keychain lookup runs off the event loop.
+ *
+ * @param serviceName - Service name prefix for keychain storage (required)
+ * @param options - Call options, e.g. an AbortSignal
+ * @returns Resolves with the stored private key in PEM format, or null if not found
+ */
+export function getPrivateKeyAsync(serviceName: string, options?: AsyncCallOptions): Promise<string | null>;
+
+/**
+ * Get the stored keys of many services with one keychain pass for those not
+ * cached (a single Secret Service search on Linux) instead of one round trip
+ * per service. Nothing is generated.
+ *
+ * @param serviceNames - Service name prefixes for keychain storage (required)
+ * @param options - Call options, e.g. an AbortSignal
+ * @returns One entry per service, in order, null where no keys are stored
+ */
+export function getKeysBulk(serviceNames: string[], options?: AsyncCallOptions): Promise<Array<KeyPair | null>>;
+
+/**
+ * Load the stored keys of many services into the keychain cache with one
+ * keychain pass, so later reads of those services are served from memory.
+ * Has no lasting effect unless the cache is enabled (configure({ cacheTtlMs })).
+ *
+ * @param serviceNames - Service name prefixes for keychain storage (required)
+ * @param options - Call options, e.g. an AbortSignal
+ * @returns Number of services whose keys were found
+ */
+export function prefetch(serviceNames: string[], options?: AsyncCallOptions): Promise<number>;
+
+/**
+ * Async variant of regenerateKeys. Key generation and keychain I/O run off the event loop.
+ *
+ * @param serviceName - Service name prefix for keychain storage (required)
+ * @param keyLength - RSA key length in bits (default: 2048)
+ * @param options - Call options, e.g. an AbortSignal
+ * @returns Resolves with the new public key in PEM format, or null if generation fails
+ */
+export function regenerateKeysAsync(serviceName: string, keyLength?: number, options?: AsyncCallOptions): Promise<string | null>;
+
+/**
+ * An RSA key pair in PEM format.
+ */
+export interface KeyPair {
+    publicKey: string;
+    privateKey: string;
+}
+
+/**
+ * Options for configureKeyPool.
+ */
+export interface KeyPoolOptions {
+    /** RSA key length in bits, 512 to 16384 (default: 2048) */
+    keyLength?: number;
+    /** RSA public exponent (default: 65537) */
+    publicExponent?: number;
+    /** Refill starts when the pool drops below this many keys (default: 2) */
+    lowWatermark?: number;
+    /** Refill stops once the pool holds this many keys (default: 8) */
+    highWatermark?: number;
+    /** Number of background refill threads shared by all pools (default: 1); lowering it retires threads */
+    threads?: number;
+}
+
+/**
+ * Depth and counters of one key pool.
+ */
+export interface KeyPoolStats {
+    keyLength: number;
+    publicExponent: number;
+    available: number;
+    lowWatermark: number;
+    highWatermark: number;
+    hits: number;
+    misses: number;
+    generated: number;
+    refilling: boolean;
+    /** Generation failed for this configuration; refill stays off until configureKeyPool is called again */
+    failed: boolean;
+}
+
+/**
+ * Configure a background pool of pre-generated key pairs for one key length
+ * and public exponent. Background threads refill the pool up to highWatermark
+ * whenever it drops below lowWatermark. A highWatermark of 0 removes the pool.
+ * generateKeys/regenerateKeys draw from a pool matching their key length.
+ *
+ * @param options - Pool options
+ */
+export function configureKeyPool(options: KeyPoolOptions): void;
+
+/**
+ * Take a pre-generated key pair from the pool. Never generates, since that
+ * would block the event loop: returns null when no pool is configured for
+ * the key length and exponent or the pool is empty (an empty pool starts
+ * refilling). The key pair is not stored in the keychain.
+ *
+ * @param keyLength - RSA key length in bits, 512 to 16384 (default: 2048)
+ * @param publicExponent - RSA public exponent (default: 65537)
+ * @returns The key pair in PEM format, or null on a pool miss
+ */
+export function takeKey(keyLength?: number, publicExponent?: number): KeyPair | null;
+
+/**
+ * Get the depth and hit/miss counters of every configured key pool.
+ *
+ * @returns One entry per pool
+ */
+export function getKeyPoolStats(): KeyPoolStats[];
+
+/**
+ * Options for generateKeysBatch.
+ */
+export interface BatchOptions {
+    /** RSA public exponent (default: 65537) */
+    publicExponent?: number;
+    /** Maximum number of threads to use (default: all hardware threads) */
+    concurrency?: number;
+    /** Key pairs per onChunk call (default: 16) */
+    chunkSize?: number;
+    /** Receives completed key pairs as they are generated */
+    onChunk?: (keys: KeyPair[]) => void;
+}
+
+/**
+ * Outcome of generateKeysBatch.
+ */
+export interface BatchResult {
+    /** Number of key pairs generated */
+    count: number;
+    /** Number of key pairs that failed to generate */
+    failed: number;
+    elapsedMs: number;
+    keysPerSecond: number;
+    /** Number of threads used */
+    threads: number;
+    /** The generated key pairs, present only when no onChunk callback was given */
+    keys?: KeyPair[];
+}
+
+/**
+ * Generate many key pairs in parallel on a native thread pool sized to the
+ * machine. The key pairs are not stored in the keychain.
+ * When options.onChunk is given, completed key pairs are streamed to it in
+ * groups of options.chunkSize and the result omits the keys array.
+ *
+ * @param count - Number of key pairs to generate, at most 100000 (required)
+ * @param keyLength - RSA key length in bits, 512 to 16384 (default: 2048)
+ * @param options - Batch options
+ * @returns Resolves with the batch outcome and throughput
+ */
+export function generateKeysBatch(count: number, keyLength?: number, options?: BatchOptions): Promise<BatchResult>;
+
+/**
+ * Module-wide settings for configure.
+ */
+export interface ConfigureOptions {
+    /** Search for the two primes of keys >= 2048 bits on multiple threads (default: false) */
+    parallelKeygen?: boolean;
+    /** Prime search threads per key, extra threads search speculatively (default: 2-4 depending on cores) */
+    parallelKeygenThreads?: number;
+    /** Give every native thread that generates or converts keys its own OpenSSL library context instead of sharing the default one (default: false) */
+    isolatedCryptoContexts?: boolean;
+    /** Let only one process on the machine generate keys for a service on a keychain miss; the others wait and then read (default: false) */
+    crossProcessLock?: boolean;
+    /** How long to wait for the cross-process lock before generating anyway (default: 60000) */
+    crossProcessLockTimeoutMs?: number;
+    /** Return newly generated keys before they are stored; the keychain write runs in the background and the keys are served from memory until it lands. Ignored while crossProcessLock is on (default: false) */
+    writeBehind?: boolean;
+    /** Retries of a failed background write before it is given up (default: 5) */
+    writeBehindRetries?: number;
+    /** Delay before the first retry, doubled for each further retry (default: 200) */
+    writeBehindRetryDelayMs?: number;
+    /** Keep keys read from the keychain in memory for this long, 0 disables the cache (default: 0) */
+    cacheTtlMs?: number;
+    /** Maximum number of cached keychain entries, least recently used are evicted (default: 1024) */
+    cacheMaxEntries?: number;
+    /** Remember keychain misses for this long so repeated misses skip the keychain, 0 disables (default: 0) */
+    negativeCacheTtlMs?: number;
+    /** Hold keychain requests on the keyring thread for this long so identical concurrent reads share one lookup, 0 dispatches immediately (default: 0) */
+    keyringBatchWindowMs?: number;
+    /** Deadline for each keychain call; a call that misses it yields null (or false for writes) and never generates new keys, 0 waits indefinitely (default: 0) */
+    keyringTimeoutMs?: number;
+    /** Fail keychain calls fast after this many consecutive timeouts, 0 disables (default: 5) */
+    circuitBreakerThreshold?: number;
+    /** How long the breaker fails calls before letting a trial call through (default: 30000) */
+    circuitBreakerCooldownMs?: number;
+    /** 'system' uses the OS credential store; 'kernel' uses the Linux kernel keyring; 'memory' keeps keys in this process only; 'file' uses an encrypted keystore file (default: KEYRING_BACKEND env var, else 'system', or 'kernel' on Linux builds without libsecret) */
+    keyringBackend?: "system" | "kernel" | "memory" | "file";
+    /** Kernel keyring used by the 'kernel' backend (default: 'user') */
+    kernelKeyring?: "user" | "session" | "persistent";
+    /** File used by the 'file' backend (default: KEYSTORE_PATH env var, else keystore.bin under the user's data directory) */
+    keystorePath?: string;
+    /** 'string' returns keys as strings; 'buffer' as Buffers over the native memory (typed as string here, convert with toString()) (default: 'string') */
+    keyOutput?: "string" | "buffer";
+    /** Encoding of returned keys: 'pkcs1-pem', 'pkcs8-pem' (SPKI/PKCS#8), 'pkcs1-der' and 'pkcs8-der' as Buffers, or 'raw' as RawKey objects (typed as string here); keys are still stored as PKCS#1 PEM (default: 'pkcs1-pem') */
+    keyFormat?: "pkcs1-pem" | "pkcs8-pem" | "pkcs1-der" | "pkcs8-der" | "raw";
+    /** How keys are read; writes store {serviceName}PublicKey, {serviceName}PrivateKey and a {serviceName}KeyPair item in either layout. 'split' reads the two single-key items; 'packed' reads the KeyPair item and migrates split items on read (default: 'split') */
+    storageLayout?: "split" | "packed";
+}
+
+/**
+ * Big-endian key components returned with keyFormat 'raw'. Private keys
+ * carry all five, public keys only n and e.
+ */
+export interface RawKey {
+    n: Buffer;
+    e: Buffer;
+    d?: Buffer;
+    p?: Buffer;
+    q?: Buffer;
+}
+
+/**
+ * Apply module-wide settings. Options that are not given keep their current value.
+ *
+ * @param options - Settings
+ */
+export function configure(options: ConfigureOptions): void;
+
+/**
+ * Get the name of the keychain backend in use.
+ */
+export function getKeyringBackend(): "system" | "kernel" | "memory" | "file";
+
+/**
+ * Size and counters of the in-memory keychain cache.
+ */
+export interface CacheStats {
+    entries: number;
+    maxEntries: number;
+    ttlMs: number;
+    hits: number;
+    misses: number;
+    evictions: number;
+    /** Number of remembered misses */
+    missingEntries: number;
+    negativeTtlMs: number;
+    /** Lookups answered by a remembered miss */
+    negativeHits: number;
+}
+
+/**
+ * Get the size and hit/miss counters of the in-memory keychain cache.
+ *
+ * @returns Cache statistics
+ */
+export function getCacheStats(): CacheStats;
+
+/**
+ * Drop cached keys for one service, or the whole in-memory keychain cache
+ * when no serviceName is given. The keychain itself is not modified.
+ *
+ * @param serviceName - Service name prefix whose keys to drop
+ */
+export function clearCache(serviceName?: string): void;
+
+/**
+ * Rewrite keychain items stored by earlier versions under the libsecret
+ * network schema into the Generic schema, so later lookups take a single
+ * round trip. Only items named {serviceName}PublicKey/PrivateKey/KeyPair are
+ * touched. Does nothing on Windows and macOS.
+ *
+ * @returns Number of migrated items
+ */
+export function migrateLegacyKeychainItems(): number;
+
+/**
+ * Size of the 'file' backend's keystore.
+ */
+export interface KeystoreStats {
+    path: string;
+    /** Bytes freed by this compaction */
+    reclaimedBytes: number;
+    /** Bytes of the keystore in use, header included */
+    fileBytes: number;
+    /** Bytes of current records */
+    liveBytes: number;
+    records: number;
+}
+
+/**
+ * Rewrite the keystore file of the 'file' backend without superseded
+ * records. Runs automatically once the file is mostly superseded records.
+ * The rewrite runs on the keyring thread, after the reads and writes queued
+ * before it.
+ *
+ * @returns Keystore size after compaction, or null if the keystore cannot be opened
+ */
+export function compactKeystore(): Promise<KeystoreStats | null>;
+
+/**
+ * Delete the stored keys of one service from the keychain, in both storage
+ * layouts ({serviceName}PublicKey/PrivateKey and {serviceName}KeyPair).
+ *
+ * @param serviceName - Service name prefix for keychain storage (required)
+ * @returns True if keys were deleted, false if none were stored or deletion failed
+ */
+export function clearKeys(serviceName: string): boolean;
+
+/**
+ * Delete the stored keys of every service whose name starts with prefix,
+ * e.g. 'tenant-' for all tenants, with one keychain search-and-delete pass.
+ *
+ * @param prefix - Service name prefix, must not be empty
+ * @returns Number of deleted keychain items, or -1 if the keychain could not be searched or an item could not be deleted
+ */
+export function clearKeysByPrefix(prefix: string): number;
+
+/**
+ * Async variant of clearKeysByPrefix. The search and the deletes run on the
+ * keyring thread, so the event loop is not blocked.
+ *
+ * @param prefix - Service name prefix, must not be empty
+ * @param options - Call options
+ * @returns Resolves with the number of deleted keychain items, or -1 as clearKeysByPrefix
+ */
+export function clearKeysByPrefixAsync(prefix: string, options?: AsyncCallOptions): Promise<number>;
+
+/**
+ * Wait until every key stored in the background by writeBehind before this
+ * call is in the keychain.
+ *
+ * @param timeoutMs - Give up waiting after this long, 0 waits indefinitely (default: 0)
+ * @returns Resolves with true once all of them are stored, false if a write was given up after its retries or the timeout expired
+ */
+export function flush(timeoutMs?: number): Promise<boolean>;
+
+/**
+ * Milliseconds spent by each OpenSSL warmup step.
+ */
+export interface WarmupStats {
+    /** OPENSSL_init_crypto, config and provider loading */
+    initMs: number;
+    /** RSA key management fetch and keygen context */
+    keymgmtMs: number;
+    /** First PEM/DER encode and decode */
+    encodersMs: number;
+    /** Seeding the random generators */
+    drbgMs: number;
+    totalMs: number;
+    /** Whether the warmup ran at load time (RSA_KEYS_WARMUP) */
+    onLoad: boolean;
+}
+
+/**
+ * Initialize OpenSSL (config, providers, RSA key management, encoders and
+ * random generators) now instead of on the first key request. Runs once per
+ * process, also at load time when RSA_KEYS_WARMUP=1 is set; later calls
+ * return the timings of that run.
  *
- * @returns False (not implemented)
+ * @returns Milliseconds spent per step
  */
-export function clearKeys(): boolean;
+export function warmup(): WarmupStats;
 
 /**
  * Default export of the module
@@ -75,6 +455,26 @@ declare const keysGenerator: {
     getPlatform: typeof getPlatform;
     regenerateKeys: typeof regenerateKeys;
     clearKeys: typeof clearKeys;
+    clearKeysByPrefix: typeof clearKeysByPrefix;
+    clearKeysByPrefixAsync: typeof clearKeysByPrefixAsync;
+    generateKeysAsync: typeof generateKeysAsync;
+    getPublicKeyAsync: typeof getPublicKeyAsync;
+    getPrivateKeyAsync: typeof getPrivateKeyAsync;
+    getKeysBulk: typeof getKeysBulk;
+    prefetch: typeof prefetch;
+    regenerateKeysAsync: typeof regenerateKeysAsync;
+    configureKeyPool: typeof configureKeyPool;
+    takeKey: typeof takeKey;
+    getKeyPoolStats: typeof getKeyPoolStats;
+    generateKeysBatch: typeof generateKeysBatch;
+    configure: typeof configure;
+    getKeyringBackend: typeof getKeyringBackend;
+    getCacheStats: typeof getCacheStats;
+    clearCache: typeof clearCache;
+    migrateLegacyKeychainItems: typeof migrateLegacyKeychainItems;
+    compactKeystore: typeof compactKeystore;
+    flush: typeof flush;
+    warmup: typeof warmup;
 };
 
 export default keysGenerator;
\ No newline at end of file
@@ -91,13 +91,282 @@ function regenerateKeys(serviceName, keyLength) {
 }
 
 /**
- * Clear stored keys from the system keychain.
- * Note: This functionality is not implemented in the current version.
+ * Async variant of generateKeys. Key generation and keychain I/O run on the
+ * libuv thread pool, so the event loop is not blocked.
  *
- * @returns {boolean} - False (not implemented)
+ * @param {string} serviceName - Service name prefix for keychain storage (required)
+ * @param {number} [keyLength] - RSA key length in bits (default: from RSA_KEY_LENGTH env var or 2048)
+ * @param {Object} [options] - Call options
+ * @param {AbortSignal} [options.signal] - Rejects with the signal's reason, generating and storing nothing, if aborted before the call starts
+ * @returns {Promise<string|null>} - Resolves with the public key in PEM format, or null if generation fails
+ */
+function generateKeysAsync(serviceName, keyLength, options) {
+    return keysGenerator.generateKeysAsync(serviceName, keyLength, options && options.signal);
+}
+
+/**
+ * Async variant of getPublicKey. The keychain lookup runs off the event loop.
+ *
+ * @param {string} serviceName - Service name prefix for keychain storage (required)
+ * @param {Object} [options] - Call options
+ * @param {AbortSignal} [options.signal] - Stops the lookup and rejects with the signal's reason when aborted
+ * @returns {Promise<string|null>} - Resolves with the stored public key in PEM format, or null if not found
+ */
+function getPublicKeyAsync(serviceName, options) {
+    return keysGenerator.getPublicKeyAsync(serviceName, options && options.signal);
+}
+
+/**
+ * Async variant of getPrivateKey. The keychain lookup runs off the event loop.
+ *
+ * @param {string} serviceName - Service name prefix for keychain storage (required)
+ * @param {Object} [options] - Call options
+ * @param {AbortSignal} [options.signal] - Stops the lookup and rejects with the signal's reason when aborted
+ * @returns {Promise<string|null>} - Resolves with the stored private key in PEM format, or null if not found
+ */
+function getPrivateKeyAsync(serviceName, options) {
+    return keysGenerator.getPrivateKeyAsync(serviceName, options && options.signal);
+}
+
+/**
+ * Get the stored keys of many services with one keychain pass for those not
+ * cached (a single Secret Service search on Linux) instead of one round trip
+ * per service. Nothing is generated.
+ *
+ * @param {string[]} serviceNames - Service name prefixes for keychain storage (required)
+ * @param {Object} [options] - Call options
+ * @param {AbortSignal} [options.signal] - Rejects with the signal's reason when aborted; a keychain pass that has not started is skipped
+ * @returns {Promise<Array<{publicKey: string, privateKey: string}|null>>} - One entry per service, in order, null where no keys are stored
+ */
+function getKeysBulk(serviceNames, options) {
+    return keysGenerator.getKeysBulk(serviceNames, options && options.signal);
+}
+
+/**
+ * Load the stored keys of many services into the keychain cache with one
+ * keychain pass, so later reads of those services are served from memory.
+ * Has no lasting effect unless the cache is enabled (configure({ cacheTtlMs })).
+ *
+ * @param {string[]} serviceNames - Service name prefixes for keychain storage (required)
+ * @param {Object} [options] - Call options
+ * @param {AbortSignal} [options.signal] - Rejects with the signal's reason when aborted; a keychain pass that has not started is skipped
+ * @returns {Promise<number>} - Number of services whose keys were found
+ */
+function prefetch(serviceNames, options) {
+    return keysGenerator.prefetch(serviceNames, options && options.signal);
+}
+
+/**
+ * Async variant of regenerateKeys. Key generation and keychain I/O run off the event loop.
+ *
+ * @param {string} serviceName - Service name prefix for keychain storage (required)
+ * @param {number} [keyLength] - RSA key length in bits (default: 2048)
+ * @param {Object} [options] - Call options
+ * @param {AbortSignal} [options.signal] - Rejects with the signal's reason, storing nothing, if aborted before the new key pair is stored
+ * @returns {Promise<string|null>} - Resolves with the new public key in PEM format, or null if generation fails
+ */
+function regenerateKeysAsync(serviceName, keyLength, options) {
+    return keysGenerator.regenerateKeysAsync(serviceName, keyLength, options && options.signal);
+}
+
+/**
+ * Configure a background pool of pre-generated key pairs for one key length
+ * and public exponent. Background threads refill the pool up to highWatermark
+ * whenever it drops below lowWatermark. A highWatermark of 0 removes the pool.
+ * generateKeys/regenerateKeys draw from a pool matching their key length.
+ *
+ * @param {Object} options - Pool options
+ * @param {number} [options.keyLength] - RSA key length in bits, 512 to 16384 (default: 2048)
+ * @param {number} [options.publicExponent] - RSA public exponent (default: 65537)
+ * @param {number} [options.lowWatermark] - Refill starts below this many keys (default: 2)
+ * @param {number} [options.highWatermark] - Refill stops at this many keys (default: 8)
+ * @param {number} [options.threads] - Number of background refill threads shared by all pools (default: 1)
+ */
+function configureKeyPool(options) {
+    keysGenerator.configureKeyPool(options);
+}
+
+/**
+ * Take a pre-generated key pair from the pool. Never generates, since that
+ * would block the event loop: returns null when no pool is configured for
+ * the key length and exponent or the pool is empty (an empty pool starts
+ * refilling). The key pair is not stored in the keychain.
+ *
+ * @param {number} [keyLength] - RSA key length in bits, 512 to 16384 (default: 2048)
+ * @param {number} [publicExponent] - RSA public exponent (default: 65537)
+ * @returns {{publicKey: string, privateKey: string}|null} - The key pair in PEM format, or null on a pool miss
+ */
+function takeKey(keyLength, publicExponent) {
+    return keysGenerator.takeKey(keyLength, publicExponent);
+}
+
+/**
+ * Get the depth and hit/miss counters of every configured key pool.
+ *
+ * @returns {Array<Object>} - One entry per pool
+ */
+function getKeyPoolStats() {
+    return keysGenerator.getKeyPoolStats();
+}
+
+/**
+ * Generate many key pairs in parallel on a native thread pool sized to the
+ * machine. The key pairs are not stored in the keychain.
+ * When options.onChunk is given, completed key pairs are streamed to it in
+ * groups of options.chunkSize and the result omits the keys array.
+ *
+ * @param {number} count - Number of key pairs to generate, at most 100000 (required)
+ * @param {number} [keyLength] - RSA key length in bits, 512 to 16384 (default: 2048)
+ * @param {Object} [options] - Batch options
+ * @param {number} [options.publicExponent] - RSA public exponent (default: 65537)
+ * @param {number} [options.concurrency] - Maximum threads to use (default: all hardware threads)
+ * @param {number} [options.chunkSize] - Key pairs per onChunk call (default: 16)
+ * @param {function(Array<{publicKey: string, privateKey: string}>)} [options.onChunk] - Receives completed key pairs
+ * @returns {Promise<Object>} - Resolves with count, failed, elapsedMs, keysPerSecond, threads and (without onChunk) keys
+ */
+function generateKeysBatch(count, keyLength, options) {
+    return keysGenerator.generateKeysBatch(count, keyLength, options);
+}
+
+/**
+ * Apply module-wide settings. Options that are not given keep their current value.
+ *
+ * @param {Object} options - Settings
+ * @param {boolean} [options.parallelKeygen] - Search for the two primes of keys >= 2048 bits on multiple threads (default: false)
+ * @param {number} [options.parallelKeygenThreads] - Prime search threads per key, extra threads search speculatively (default: 2-4 depending on cores)
+ * @param {boolean} [options.isolatedCryptoContexts] - Give every native thread that generates or converts keys its own OpenSSL library context instead of sharing the default one (default: false)
+ * @param {boolean} [options.crossProcessLock] - Let only one process on the machine generate keys for a service on a keychain miss; the others wait and then read (default: false)
+ * @param {number} [options.crossProcessLockTimeoutMs] - How long to wait for the lock before generating anyway (default: 60000)
+ * @param {boolean} [options.writeBehind] - Return newly generated keys before they are stored; the keychain write runs in the background and the keys are served from memory until it lands. Ignored while crossProcessLock is on (default: false)
+ * @param {number} [options.writeBehindRetries] - Retries of a failed background write before it is given up (default: 5)
+ * @param {number} [options.writeBehindRetryDelayMs] - Delay before the first retry, doubled for each further retry (default: 200)
+ * @param {number} [options.cacheTtlMs] - Keep keys read from the keychain in memory for this long, 0 disables the cache (default: 0)
+ * @param {number} [options.cacheMaxEntries] - Maximum number of cached keychain entries, least recently used are evicted (default: 1024)
+ * @param {number} [options.negativeCacheTtlMs] - Remember keychain misses for this long so repeated misses skip the keychain, 0 disables (default: 0)
+ * @param {number} [options.keyringTimeoutMs] - Deadline for each keychain call; a call that misses it yields null (or false for writes) and never generates new keys, 0 waits indefinitely (default: 0)
+ * @param {number} [options.circuitBreakerThreshold] - Fail keychain calls fast after this many consecutive timeouts, 0 disables (default: 5)
+ * @param {number} [options.circuitBreakerCooldownMs] - How long the breaker fails calls before letting a trial call through (default: 30000)
+ * @param {number} [options.keyringBatchWindowMs] - Hold keychain requests on the keyring thread for this long so identical concurrent reads share one lookup, 0 dispatches immediately (default: 0)
+ * @param {string} [options.keyringBackend] - 'system' uses the OS credential store; 'kernel' uses the Linux kernel keyring; 'memory' keeps keys in this process only; 'file' uses an encrypted keystore file (default: KEYRING_BACKEND env var, else 'system', or 'kernel' on Linux builds without libsecret)
+ * @param {string} [options.kernelKeyring] - Kernel keyring used by the 'kernel' backend: 'user', 'session' or 'persistent' (default: 'user')
+ * @param {string} [options.keystorePath] - File used by the 'file' backend (default: KEYSTORE_PATH env var, else keystore.bin under the user's data directory)
+ * @param {string} [options.keyOutput] - 'string' returns keys as strings; 'buffer' as Buffers over the native memory (default: 'string')
+ * @param {string} [options.keyFormat] - Encoding of returned keys: 'pkcs1-pem', 'pkcs8-pem' (SPKI/PKCS#8), 'pkcs1-der' and 'pkcs8-der' as Buffers, or 'raw' as {n, e, d, p, q} Buffers; keys are still stored as PKCS#1 PEM (default: 'pkcs1-pem')
+ * @param {string} [options.storageLayout] - How keys are read; writes store {serviceName}PublicKey, {serviceName}PrivateKey and a {serviceName}KeyPair item in either layout. 'split' reads the two single-key items; 'packed' reads the KeyPair item and migrates split items on read (default: 'split')
+ */
+function configure(options) {
+    keysGenerator.configure(options);
+}
+
+/**
+ * Get the name of the keychain backend in use.
+ *
+ * @returns {string} - 'system', 'kernel', 'memory' or 'file'
+ */
+function getKeyringBackend() {
+    return keysGenerator.getKeyringBackend();
+}
+
+/**
+ * Get the size and hit/miss counters of the in-memory keychain cache.
+ *
+ * @returns {{entries: number, maxEntries: number, ttlMs: number, hits: number, misses: number, evictions: number,
+ *            missingEntries: number, negativeTtlMs: number, negativeHits: number}}
+ */
+function getCacheStats() {
+    return keysGenerator.getCacheStats();
+}
+
+/**
+ * Drop cached keys for one service, or the whole in-memory keychain cache
+ * when no serviceName is given. The keychain itself is not modified.
+ *
+ * @param {string} [serviceName] - Service name prefix whose keys to drop
+ */
+function clearCache(serviceName) {
+    keysGenerator.clearCache(serviceName);
+}
+
+/**
+ * Rewrite keychain items stored by earlier versions under the libsecret
+ * network schema into the Generic schema, so later lookups take a single
+ * round trip. Only items named {serviceName}PublicKey/PrivateKey/KeyPair are
+ * touched. Does nothing on Windows and macOS.
+ *
+ * @returns {number} - Number of migrated items
+ */
+function migrateLegacyKeychainItems() {
+    return keysGenerator.migrateLegacyKeychainItems();
+}
+
+/**
+ * Rewrite the keystore file of the 'file' backend without superseded
+ * records. Runs automatically once the file is mostly superseded records.
+ * The rewrite runs on the keyring thread, after the reads and writes queued
+ * before it.
+ *
+ * @returns {Promise<{path: string, reclaimedBytes: number, fileBytes: number, liveBytes: number, records: number}|null>} - Keystore size after compaction, or null if the keystore cannot be opened
+ */
+function compactKeystore() {
+    return keysGenerator.compactKeystore();
+}
+
+/**
+ * Delete the stored keys of one service from the keychain, in both storage
+ * layouts ({serviceName}PublicKey/PrivateKey and {serviceName}KeyPair).
+ *
+ * @param {string} serviceName - Service name prefix for keychain storage (required)
+ * @returns {boolean} - True if keys were deleted, false if none were stored or deletion failed
+ */
+function clearKeys(serviceName) {
+    return keysGenerator.clearKeys(serviceName);
+}
+
+/**
+ * Delete the stored keys of every service whose name starts with prefix,
+ * e.g. 'tenant-' for all tenants, with one keychain search-and-delete pass.
+ *
+ * @param {string} prefix - Service name prefix, must not be empty
+ * @returns {number} - Number of deleted keychain items, or -1 if the keychain could not be searched or an item could not be deleted
+ */
+function clearKeysByPrefix(prefix) {
+    return keysGenerator.clearKeysByPrefix(prefix);
+}
+
+/**
+ * Async variant of clearKeysByPrefix. The search and the deletes run on the
+ * keyring thread, so the event loop is not blocked.
+ *
+ * @param {string} prefix - Service name prefix, must not be empty
+ * @param {Object} [options] - Call options
+ * @param {AbortSignal} [options.signal] - Rejects with the signal's reason, deleting nothing, if aborted before the deletes start
+ * @returns {Promise<number>} - Resolves with the number of deleted keychain items, or -1 as clearKeysByPrefix
+ */
+function clearKeysByPrefixAsync(prefix, options) {
+    return keysGenerator.clearKeysByPrefixAsync(prefix, options && options.signal);
+}
+
+/**
+ * Wait until every key stored in the background by writeBehind before this
+ * call is in the keychain.
+ *
+ * @param {number} [timeoutMs] - Give up waiting after this long, 0 waits indefinitely (default: 0)
+ * @returns {Promise<boolean>} - Resolves with true once all of them are stored, false if a write was given up after its retries or the timeout expired
+ */
+function flush(timeoutMs) {
+    return keysGenerator.flush(timeoutMs);
+}
+
+/**
+ * Initialize OpenSSL (config, providers, RSA key management, encoders and
+ * random generators) now instead of on the first key request. Runs once per
+ * process, also at load time when RSA_KEYS_WARMUP=1 is set; later calls
+ * return the timings of that run.
+ *
+ * @returns {{initMs: number, keymgmtMs: number, encodersMs: number, drbgMs: number, totalMs: number, onLoad: boolean}} - Milliseconds spent per step, and whether it ran at load time
  */
-function clearKeys() {
-    return keysGenerator.clearKeys();
+function warmup() {
+    return keysGenerator.warmup();
 }
 
 module.exports = {
@@ -107,5 +376,25 @@ module.exports = {
     isKeychainAvailable,
     getPlatform,
     regenerateKeys,
-    clearKeys
+    clearKeys,
+    clearKeysByPrefix,
+    clearKeysByPrefixAsync,
+    generateKeysAsync,
+    getPublicKeyAsync,
+    getPrivateKeyAsync,
+    getKeysBulk,
+    prefetch,
+    regenerateKeysAsync,
+    configureKeyPool,
+    takeKey,
+    getKeyPoolStats,
+    generateKeysBatch,
+    configure,
+    getKeyringBackend,
+    getCacheStats,
+    clearCache,
+    migrateLegacyKeychainItems,
+    compactKeystore,
+    flush,
+    warmup
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace KeysGen {
+
+// Cancellation state of one async call, shared between the caller that
+// cancels it and the threads doing its work. A call that changes stored keys
+// commits first: once committed, cancel() has no effect, and once cancelled,
+// commit() fails, so a cancelled call never changes anything.
+class Cancellation {
+public:
+    // Runs the handlers on the calling thread; later calls do nothing
+    void cancel() {
+        std::vector<std::function<void()>> handlers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ != State::Pending) {
+                return;
+            }
+            state_ = State::Cancelled;
+            handlers.swap(handlers_);
+        }
+
+        for (auto& handler : handlers) {
+            handler();
+        }
+    }
+
+    bool cancelled() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_ == State::Cancelled;
+    }
+
+    // False if the call was cancelled; from then on it cannot be
+    bool commit() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::Cancelled) {
+            return false;
+        }
+        state_ = State::Committed;
+        return true;
+    }
+
+    // handler runs once on cancel(), or right away if already cancelled.
+    // Handlers are kept until then, so they should hold little.
+    void onCancel(std::function<void()> handler) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ != State::Cancelled) {
+                if (state_ == State::Pending) {
+                    handlers_.push_back(std::move(handler));
+                }
+                return;
+            }
+        }
+        handler();
+    }
+
+private:
+    enum class State { Pending, Cancelled, Committed };
+
+    mutable std::mutex mutex_;
+    State state_ = State::Pending;
+    std::vector<std::function<void()>> handlers_;
+};
+
+using CancellationPtr = std::shared_ptr<Cancellation>;
+
+} // namespace KeysGen
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+namespace KeysGen {
+
+// Fails calls fast once `threshold` consecutive calls timed out. After
+// `cooldown` a single trial call is let through: success closes the breaker,
+// another timeout keeps it open for a further cooldown. threshold 0 disables it.
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void configure(int threshold, std::chrono::milliseconds cooldown) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (threshold >= 0) {
+            threshold_ = threshold;
+        }
+        if (cooldown.count() >= 0) {
+            cooldown_ = cooldown;
+        }
+        if (threshold_ == 0) {
+            reset();
+        }
+    }
+
+    // Whether a call may go to the backend now
+    bool allow() {
+        bool trial = false;
+        return allow(trial);
+    }
+
+    // Same, and whether the call is the single trial of an open breaker
+    bool allow(bool& trial) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        trial = false;
+        if (!open_) {
+            return true;
+        }
+        if (Clock::now() < openUntil_ || trialInFlight_) {
+            return false;
+        }
+        trialInFlight_ = true;
+        trial = true;
+        return true;
+    }
+
+    // The trial call was given up by its caller before it completed; the
+    // next call becomes the trial
+    void releaseTrial() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        trialInFlight_ = false;
+    }
+
+    // The call completed in time, whatever its result
+    void recordSuccess() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reset();
+    }
+
+    void recordTimeout() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        consecutiveTimeouts_++;
+        trialInFlight_ = false;
+        if (threshold_ > 0 && (open_ || consecutiveTimeouts_ >= threshold_)) {
+            open_ = true;
+            openUntil_ = Clock::now() + cooldown_;
+        }
+    }
+
+    bool isOpen() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return open_;
+    }
+
+private:
+    void reset() {
+        consecutiveTimeouts_ = 0;
+        open_ = false;
+        trialInFlight_ = false;
+    }
+
+    mutable std::mutex mutex_;
+    int threshold_ = 5;
+    std::chrono::milliseconds cooldown_{30000};
+    int consecutiveTimeouts_ = 0;
+    bool open_ = false;
+    bool trialInFlight_ = false;
+    Clock::time_point openUntil_;
+};
+
+} // namespace KeysGen
\ No newline at end of file
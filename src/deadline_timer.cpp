@@ -0,0 +1,102 @@
+#include "deadline_timer.h"
+#include <utility>
+
+namespace KeysGen {
+
+DeadlineTimer& DeadlineTimer::shared() {
+    static DeadlineTimer timer;
+    return timer;
+}
+
+DeadlineTimer::~DeadlineTimer() {
+    shutdown();
+}
+
+uint64_t DeadlineTimer::schedule(std::chrono::milliseconds delay, std::function<void()> fn) {
+    Clock::time_point deadline = Clock::now() + delay;
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = nextId_++;
+        deadlines_.emplace(deadline, id);
+        callbacks_.emplace(id, std::make_pair(deadline, std::move(fn)));
+        if (!worker_.joinable()) {
+            worker_ = std::thread(&DeadlineTimer::workerLoop, this);
+        }
+    }
+    changed_.notify_one();
+    return id;
+}
+
+bool DeadlineTimer::cancel(uint64_t id) {
+    std::function<void()> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = callbacks_.find(id);
+    if (it == callbacks_.end()) {
+        return false;
+    }
+
+    auto range = deadlines_.equal_range(it->second.first);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+        if (entry->second == id) {
+            deadlines_.erase(entry);
+            break;
+        }
+    }
+    // Destroyed after the lock is released, captures may be heavy
+    dropped = std::move(it->second.second);
+    callbacks_.erase(it);
+    return true;
+}
+
+void DeadlineTimer::shutdown() {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!worker_.joinable()) {
+            return;
+        }
+        stopping_ = true;
+        worker.swap(worker_);
+    }
+    changed_.notify_all();
+    worker.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    deadlines_.clear();
+    callbacks_.clear();
+    stopping_ = false;
+}
+
+void DeadlineTimer::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (deadlines_.empty()) {
+            changed_.wait(lock);
+            continue;
+        }
+
+        auto next = deadlines_.begin();
+        if (Clock::now() < next->first) {
+            changed_.wait_until(lock, next->first);
+            continue;
+        }
+
+        uint64_t id = next->second;
+        deadlines_.erase(next);
+        auto it = callbacks_.find(id);
+        std::function<void()> fn = std::move(it->second.second);
+        callbacks_.erase(it);
+
+        lock.unlock();
+        try {
+            fn();
+        } catch (...) {
+            // Deadline handlers report through their own state
+        }
+        fn = nullptr;
+        lock.lock();
+    }
+}
+
+} // namespace KeysGen
\ No newline at end of file
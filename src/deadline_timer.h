@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace KeysGen {
+
+// One native thread that runs callbacks when their deadline passes. Used to
+// bound keyring calls: it keeps running while the keyring thread is stuck.
+class DeadlineTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static DeadlineTimer& shared();
+
+    // Runs fn on the timer thread after delay; returns an id for cancel()
+    uint64_t schedule(std::chrono::milliseconds delay, std::function<void()> fn);
+    // Drops a callback that has not run yet; returns false if it already ran
+    bool cancel(uint64_t id);
+
+    // Drops pending callbacks and joins the thread; it restarts on next use
+    void shutdown();
+
+    ~DeadlineTimer();
+
+private:
+    DeadlineTimer() = default;
+    void workerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::multimap<Clock::time_point, uint64_t> deadlines_;
+    std::unordered_map<uint64_t, std::pair<Clock::time_point, std::function<void()>>> callbacks_;
+    uint64_t nextId_ = 1;
+    std::thread worker_;
+    bool stopping_ = false;
+};
+
+} // namespace KeysGen
\ No newline at end of file
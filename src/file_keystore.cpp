@@ -0,0 +1,859 @@
+#include "file_keystore.h"
+#include "keyring.h"
+#include "platform_utils.h"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace KeysGen {
+
+std::shared_ptr<FileKeystore> FileKeystore::shared() {
+    static std::shared_ptr<FileKeystore> instance = std::make_shared<FileKeystore>();
+    return instance;
+}
+
+void FileKeystore::setPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(pathMutex_);
+    configuredPath_ = path;
+    // The next call closes the current file
+    pathChanged_.store(true);
+}
+
+#ifdef _WIN32
+FileKeystore::~FileKeystore() = default;
+
+bool FileKeystore::isAvailable() {
+    return false;
+}
+
+void FileKeystore::get(const std::string&, const std::string&, KeyringExecutor::ReadCallback done) {
+    KeyringReadResult result;
+    result.failed = true;
+    done(std::move(result));
+}
+
+bool FileKeystore::set(const std::string&, const std::string&, const std::string&) {
+    return false;
+}
+
+std::vector<KeyringReadResult> FileKeystore::getMany(const std::vector<KeyringItem>& items) {
+    std::vector<KeyringReadResult> results(items.size());
+    for (KeyringReadResult& result : results) {
+        result.failed = true;
+    }
+    return results;
+}
+
+bool FileKeystore::removeMatching(const std::string&, const std::string&, const ServiceFilter&,
+                                  std::vector<std::string>&) {
+    return false;
+}
+
+long long FileKeystore::compact() {
+    return -1;
+}
+
+FileKeystoreStats FileKeystore::stats() {
+    return FileKeystoreStats{};
+}
+#else
+
+// File layout, in host byte order: a 64-byte header, then records back to
+// back up to header.dataEnd. A record is
+//   u32 length | u8 type | 3 zero bytes | 32-byte name hash | sealed payload
+// where a put's payload is nonce | AES-256-GCM ciphertext | tag over
+//   u32 name length | service '\0' account | password
+// and a delete has none. The store id, type and name hash are authenticated
+// as AAD, so a record cannot be replayed under another name or store.
+static const char kMagic[8] = { 'R', 'S', 'A', 'K', 'S', 'T', 'O', 'R' };
+static const uint32_t kVersion = 1;
+// Set on the old file once a compacted copy has replaced it
+static const uint32_t kFlagSuperseded = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t dataEnd;
+    uint8_t storeId[16];
+    uint8_t keyCheck[16];
+    uint8_t reserved[8];
+};
+static_assert(sizeof(FileHeader) == 64, "keystore header must be 64 bytes");
+
+static const size_t kHashSize = 32;
+static const size_t kNonceSize = 12;
+static const size_t kTagSize = 16;
+static const size_t kRecordPrefix = 8 + kHashSize;
+static const size_t kSealOverhead = kNonceSize + kTagSize;
+static const size_t kAadSize = sizeof(FileHeader::storeId) + 1 + kHashSize;
+static const uint8_t kRecordPut = 1;
+static const uint8_t kRecordDelete = 2;
+
+// The file grows in steps of at least this much
+static const size_t kGrowthStep = 64 * 1024;
+// Compact after a write once the log is this large and mostly dead records
+static const uint64_t kAutoCompactBytes = 1024 * 1024;
+
+static const char* kMasterKeyService = "keys_generator_keystore";
+
+using CipherContextPtr = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+
+static FileHeader* fileHeader(uint8_t* map) {
+    return reinterpret_cast<FileHeader*>(map);
+}
+
+// Other processes append concurrently, read the header atomically
+static uint64_t loadDataEnd(uint8_t* map) {
+    return __atomic_load_n(&fileHeader(map)->dataEnd, __ATOMIC_ACQUIRE);
+}
+
+static bool isSuperseded(uint8_t* map) {
+    return (__atomic_load_n(&fileHeader(map)->flags, __ATOMIC_ACQUIRE) & kFlagSuperseded) != 0;
+}
+
+// The flag is set after the compacted copy is renamed into place, so a
+// compaction that crashed in between only shows as a different inode
+static bool isReplaced(int fd, const std::string& path) {
+    struct stat opened;
+    struct stat current;
+    if (fstat(fd, &opened) != 0 || stat(path.c_str(), &current) != 0) {
+        return true;
+    }
+    return opened.st_dev != current.st_dev || opened.st_ino != current.st_ino;
+}
+
+static size_t roundUp(uint64_t size, size_t step) {
+    return static_cast<size_t>((size + step - 1) / step * step);
+}
+
+static std::string toHex(const uint8_t* data, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(size * 2);
+    for (size_t i = 0; i < size; i++) {
+        hex.push_back(digits[data[i] >> 4]);
+        hex.push_back(digits[data[i] & 0x0f]);
+    }
+    return hex;
+}
+
+static bool fromHex(const std::string& hex, uint8_t* out, size_t size) {
+    if (hex.size() != size * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+        int value = 0;
+        for (size_t j = 0; j < 2; j++) {
+            char c = hex[i * 2 + j];
+            int digit = c >= '0' && c <= '9' ? c - '0'
+                      : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                      : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0) {
+                return false;
+            }
+            value = value * 16 + digit;
+        }
+        out[i] = static_cast<uint8_t>(value);
+    }
+    return true;
+}
+
+static std::string defaultPath() {
+    std::string configured = PlatformUtils::getKeystorePath();
+    if (!configured.empty()) {
+        return configured;
+    }
+
+    const char* home = std::getenv("HOME");
+    std::string homeDirectory = home != nullptr && home[0] != '\0' ? home : ".";
+#ifdef __APPLE__
+    return homeDirectory + "/Library/Application Support/node-rsa-keys-generator/keystore.bin";
+#else
+    const char* dataHome = std::getenv("XDG_DATA_HOME");
+    std::string dataDirectory = dataHome != nullptr && dataHome[0] != '\0' ? dataHome : homeDirectory + "/.local/share";
+    return dataDirectory + "/node-rsa-keys-generator/keystore.bin";
+#endif
+}
+
+static bool makeParentDirectories(const std::string& path) {
+    for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+        std::string directory = path.substr(0, slash);
+        if (mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool lockFile(int fd) {
+    int rc;
+    while ((rc = flock(fd, LOCK_EX)) != 0 && errno == EINTR) {
+    }
+    return rc == 0;
+}
+
+// msync wants a page-aligned start
+static bool syncRange(uint8_t* map, uint64_t offset, uint64_t length) {
+    static const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t start = offset / pageSize * pageSize;
+    return msync(map + start, static_cast<size_t>(offset + length - start), MS_SYNC) == 0;
+}
+
+// A file without a complete header, or whose header is still all zeros,
+// holds no records yet
+static bool isUninitialized(int fd, const struct stat& status) {
+    if (static_cast<uint64_t>(status.st_size) < sizeof(FileHeader)) {
+        return true;
+    }
+    uint8_t header[sizeof(FileHeader)];
+    if (pread(fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        return false;
+    }
+    return std::all_of(header, header + sizeof(header), [](uint8_t byte) { return byte == 0; });
+}
+
+// 32 bytes from KEYSTORE_MASTER_KEY or the OS keyring, created for a new store
+static bool loadMasterKey(const std::string& storeId, bool create, uint8_t* masterKey) {
+    std::string configured = PlatformUtils::getKeystoreMasterKey();
+    if (!configured.empty()) {
+        return fromHex(configured, masterKey, 32);
+    }
+
+    auto stored = Keyring::getPasswordFrom("system", kMasterKeyService, storeId);
+    if (stored.has_value()) {
+        return fromHex(stored.value(), masterKey, 32);
+    }
+    if (!create || RAND_bytes(masterKey, 32) != 1) {
+        return false;
+    }
+    return Keyring::setPasswordIn("system", kMasterKeyService, storeId, toHex(masterKey, 32));
+}
+
+static void deriveKey(const uint8_t* masterKey, const char* label, uint8_t* out) {
+    unsigned int length = 0;
+    HMAC(EVP_sha256(), masterKey, 32, reinterpret_cast<const unsigned char*>(label), std::strlen(label), out, &length);
+}
+
+// Lets a store with the wrong master key fail to open instead of every read
+static void keyCheck(const uint8_t* indexKey, uint8_t* out) {
+    uint8_t digest[32];
+    deriveKey(indexKey, "keys_generator keystore check", digest);
+    std::memcpy(out, digest, sizeof(FileHeader::keyCheck));
+}
+
+static void buildAad(uint8_t* map, uint8_t type, const uint8_t* hash, uint8_t* aad) {
+    std::memcpy(aad, fileHeader(map)->storeId, sizeof(FileHeader::storeId));
+    aad[sizeof(FileHeader::storeId)] = type;
+    std::memcpy(aad + sizeof(FileHeader::storeId) + 1, hash, kHashSize);
+}
+
+// Writes nonce | ciphertext | tag of a put payload to out
+static bool seal(const uint8_t* key, const uint8_t* aad, const std::string& itemName,
+                 const std::string& value, uint8_t* out) {
+    uint8_t* nonce = out;
+    if (RAND_bytes(nonce, static_cast<int>(kNonceSize)) != 1) {
+        return false;
+    }
+
+    CipherContextPtr context(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    if (!context || EVP_EncryptInit_ex(context.get(), EVP_aes_256_gcm(), nullptr, key, nonce) != 1) {
+        return false;
+    }
+
+    int length = 0;
+    uint8_t* cursor = out + kNonceSize;
+    uint32_t nameLength = static_cast<uint32_t>(itemName.size());
+    // GCM is a stream mode, every update emits exactly its input length
+    auto update = [&](const void* data, size_t size) {
+        if (EVP_EncryptUpdate(context.get(), cursor, &length, static_cast<const uint8_t*>(data), static_cast<int>(size)) != 1) {
+            return false;
+        }
+        cursor += length;
+        return true;
+    };
+
+    if (EVP_EncryptUpdate(context.get(), nullptr, &length, aad, static_cast<int>(kAadSize)) != 1 ||
+        !update(&nameLength, sizeof(nameLength)) ||
+        !update(itemName.data(), itemName.size()) ||
+        !update(value.data(), value.size()) ||
+        EVP_EncryptFinal_ex(context.get(), cursor, &length) != 1) {
+        return false;
+    }
+    cursor += length;
+    return EVP_CIPHER_CTX_ctrl(context.get(), EVP_CTRL_GCM_GET_TAG, static_cast<int>(kTagSize), cursor) == 1;
+}
+
+// Decrypts a put payload straight from the mapping; false if it was
+// tampered with or belongs to another name
+static bool unseal(const uint8_t* key, const uint8_t* aad, const uint8_t* sealed, size_t sealedSize,
+                   const std::string& itemName, std::string& value) {
+    size_t ciphertextSize = sealedSize - kSealOverhead;
+    uint32_t nameLength = 0;
+    if (ciphertextSize < sizeof(nameLength) + itemName.size()) {
+        return false;
+    }
+
+    CipherContextPtr context(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    if (!context || EVP_DecryptInit_ex(context.get(), EVP_aes_256_gcm(), nullptr, key, sealed) != 1) {
+        return false;
+    }
+
+    int length = 0;
+    const uint8_t* cursor = sealed + kNonceSize;
+    auto update = [&](void* out, size_t size) {
+        if (EVP_DecryptUpdate(context.get(), static_cast<uint8_t*>(out), &length, cursor, static_cast<int>(size)) != 1) {
+            return false;
+        }
+        cursor += size;
+        return true;
+    };
+
+    std::string storedName(itemName.size(), '\0');
+    if (EVP_DecryptUpdate(context.get(), nullptr, &length, aad, static_cast<int>(kAadSize)) != 1 ||
+        !update(&nameLength, sizeof(nameLength)) || nameLength != itemName.size() ||
+        !update(&storedName[0], storedName.size()) || storedName != itemName) {
+        return false;
+    }
+
+    // The password is decrypted into its final buffer, no intermediate copy
+    value.resize(ciphertextSize - sizeof(nameLength) - itemName.size());
+    uint8_t tag[kTagSize];
+    std::memcpy(tag, sealed + sealedSize - kTagSize, kTagSize);
+    if (!update(&value[0], value.size()) ||
+        EVP_CIPHER_CTX_ctrl(context.get(), EVP_CTRL_GCM_SET_TAG, static_cast<int>(kTagSize), tag) != 1 ||
+        EVP_DecryptFinal_ex(context.get(), nullptr, &length) != 1) {
+        OPENSSL_cleanse(&value[0], value.size());
+        value.clear();
+        return false;
+    }
+    return true;
+}
+
+// Authenticates a whole put payload and returns the service '\0' account
+// name it holds, for scans that do not know the name up front
+static bool unsealItemName(const uint8_t* key, const uint8_t* aad, const uint8_t* sealed, size_t sealedSize,
+                           std::string& itemName) {
+    size_t ciphertextSize = sealedSize - kSealOverhead;
+    CipherContextPtr context(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    if (!context || EVP_DecryptInit_ex(context.get(), EVP_aes_256_gcm(), nullptr, key, sealed) != 1) {
+        return false;
+    }
+
+    std::vector<uint8_t> plaintext(ciphertextSize);
+    uint8_t tag[kTagSize];
+    std::memcpy(tag, sealed + sealedSize - kTagSize, kTagSize);
+    int length = 0;
+    bool authentic =
+        EVP_DecryptUpdate(context.get(), nullptr, &length, aad, static_cast<int>(kAadSize)) == 1 &&
+        EVP_DecryptUpdate(context.get(), plaintext.data(), &length, sealed + kNonceSize, static_cast<int>(ciphertextSize)) == 1 &&
+        EVP_CIPHER_CTX_ctrl(context.get(), EVP_CTRL_GCM_SET_TAG, static_cast<int>(kTagSize), tag) == 1 &&
+        EVP_DecryptFinal_ex(context.get(), nullptr, &length) == 1;
+
+    uint32_t nameLength = 0;
+    if (authentic && plaintext.size() >= sizeof(nameLength)) {
+        std::memcpy(&nameLength, plaintext.data(), sizeof(nameLength));
+        authentic = nameLength <= plaintext.size() - sizeof(nameLength);
+        if (authentic) {
+            itemName.assign(reinterpret_cast<const char*>(plaintext.data()) + sizeof(nameLength), nameLength);
+        }
+    } else {
+        authentic = false;
+    }
+    OPENSSL_cleanse(plaintext.data(), plaintext.size());
+    return authentic;
+}
+
+FileKeystore::~FileKeystore() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeLocked();
+}
+
+void FileKeystore::closeLocked() {
+    if (map_ != nullptr) {
+        munmap(map_, mapSize_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+    if (lockFd_ >= 0) {
+        close(lockFd_);
+    }
+    map_ = nullptr;
+    mapSize_ = 0;
+    fd_ = -1;
+    lockFd_ = -1;
+    path_.clear();
+    index_.clear();
+    indexedEnd_ = 0;
+    liveBytes_ = 0;
+    OPENSSL_cleanse(encryptionKey_, sizeof(encryptionKey_));
+    OPENSSL_cleanse(indexKey_, sizeof(indexKey_));
+}
+
+bool FileKeystore::mapLocked(size_t size) {
+    if (map_ != nullptr) {
+        munmap(map_, mapSize_);
+        map_ = nullptr;
+        mapSize_ = 0;
+    }
+
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    map_ = static_cast<uint8_t*>(map);
+    mapSize_ = size;
+    return true;
+}
+
+bool FileKeystore::openLocked() {
+    closeLocked();
+
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(pathMutex_);
+        path = configuredPath_.empty() ? defaultPath() : configuredPath_;
+    }
+    if (!makeParentDirectories(path)) {
+        return false;
+    }
+
+    lockFd_ = open((path + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (lockFd_ < 0 || !lockFile(lockFd_)) {
+        closeLocked();
+        return false;
+    }
+
+    // Closing lockFd_ (closeLocked) releases the lock on every failure path
+    bool opened = false;
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    struct stat status;
+    uint8_t masterKey[32];
+    if (fd_ >= 0 && fstat(fd_, &status) == 0) {
+        if (isUninitialized(fd_, status)) {
+            // New store: random id, master key, empty log. The header is on
+            // disk before the file grows, so a crash in between leaves a
+            // file this branch initializes again on the next open.
+            FileHeader header = {};
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.dataEnd = sizeof(FileHeader);
+            size_t size = std::max(kGrowthStep, static_cast<size_t>(status.st_size));
+            if (RAND_bytes(header.storeId, sizeof(header.storeId)) == 1 &&
+                loadMasterKey(toHex(header.storeId, sizeof(header.storeId)), true, masterKey)) {
+                deriveKey(masterKey, "keys_generator keystore encryption", encryptionKey_);
+                deriveKey(masterKey, "keys_generator keystore index", indexKey_);
+                keyCheck(indexKey_, header.keyCheck);
+                opened = pwrite(fd_, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                         fsync(fd_) == 0 && ftruncate(fd_, static_cast<off_t>(size)) == 0 && mapLocked(size);
+            }
+        } else if (mapLocked(static_cast<size_t>(status.st_size))) {
+            FileHeader* header = fileHeader(map_);
+            uint8_t check[sizeof(FileHeader::keyCheck)];
+            if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 && header->version == kVersion &&
+                loadDataEnd(map_) <= mapSize_ &&
+                loadMasterKey(toHex(header->storeId, sizeof(header->storeId)), false, masterKey)) {
+                deriveKey(masterKey, "keys_generator keystore encryption", encryptionKey_);
+                deriveKey(masterKey, "keys_generator keystore index", indexKey_);
+                keyCheck(indexKey_, check);
+                opened = CRYPTO_memcmp(check, header->keyCheck, sizeof(check)) == 0;
+            }
+        }
+    }
+    OPENSSL_cleanse(masterKey, sizeof(masterKey));
+
+    indexedEnd_ = sizeof(FileHeader);
+    if (!opened || !indexLocked(sizeof(FileHeader), loadDataEnd(map_))) {
+        closeLocked();
+        return false;
+    }
+
+    path_ = path;
+    flock(lockFd_, LOCK_UN);
+    return true;
+}
+
+// Replays records in [from, to) into the index
+bool FileKeystore::indexLocked(uint64_t from, uint64_t to) {
+    uint64_t offset = from;
+    while (offset < to) {
+        uint32_t length = 0;
+        if (to - offset < kRecordPrefix) {
+            return false;
+        }
+        std::memcpy(&length, map_ + offset, sizeof(length));
+        uint8_t type = map_[offset + 4];
+        if (length < kRecordPrefix || length > to - offset) {
+            return false;
+        }
+
+        std::string hash(reinterpret_cast<const char*>(map_ + offset + 8), kHashSize);
+        auto previous = index_.find(hash);
+        if (previous != index_.end()) {
+            liveBytes_ -= previous->second.length;
+            index_.erase(previous);
+        }
+
+        if (type == kRecordPut && length >= kRecordPrefix + kSealOverhead + sizeof(uint32_t)) {
+            index_[hash] = Entry{ offset, length };
+            liveBytes_ += length;
+        } else if (type != kRecordDelete) {
+            return false;
+        }
+        offset += length;
+    }
+
+    indexedEnd_ = to;
+    return true;
+}
+
+// Brings the mapping and index up to date with the file, opening it on
+// first use and reopening it after another process compacted it
+bool FileKeystore::refreshLocked() {
+    if (pathChanged_.exchange(false)) {
+        closeLocked();
+    }
+    if (map_ == nullptr || isSuperseded(map_)) {
+        return openLocked();
+    }
+
+    uint64_t end = loadDataEnd(map_);
+    if (end > mapSize_) {
+        // Grown by another process
+        struct stat status;
+        if (fstat(fd_, &status) != 0 || end > static_cast<uint64_t>(status.st_size) ||
+            !mapLocked(static_cast<size_t>(status.st_size))) {
+            closeLocked();
+            return false;
+        }
+    }
+    if (end > indexedEnd_ && !indexLocked(indexedEnd_, end)) {
+        closeLocked();
+        return false;
+    }
+    return true;
+}
+
+// Takes the cross-process write lock on the current file
+bool FileKeystore::lockStoreLocked() {
+    for (;;) {
+        if (!refreshLocked()) {
+            return false;
+        }
+        if (!lockFile(lockFd_)) {
+            return false;
+        }
+        if (!isSuperseded(map_) && !isReplaced(fd_, path_)) {
+            // Pick up what was appended before we got the lock
+            if (refreshLocked()) {
+                return true;
+            }
+            return false;
+        }
+        // Compacted while we waited, retry against the new file
+        closeLocked();
+    }
+}
+
+void FileKeystore::unlockStoreLocked() {
+    if (lockFd_ >= 0) {
+        flock(lockFd_, LOCK_UN);
+    }
+}
+
+std::string FileKeystore::nameHash(const std::string& itemName) const {
+    uint8_t digest[kHashSize];
+    unsigned int length = 0;
+    HMAC(EVP_sha256(), indexKey_, sizeof(indexKey_), reinterpret_cast<const unsigned char*>(itemName.data()),
+         itemName.size(), digest, &length);
+    return std::string(reinterpret_cast<const char*>(digest), kHashSize);
+}
+
+// Appends one record; the caller holds the store lock
+bool FileKeystore::appendLocked(uint8_t type, const std::string& itemName, const std::string* value) {
+    uint64_t length = kRecordPrefix;
+    if (type == kRecordPut) {
+        length += kSealOverhead + sizeof(uint32_t) + itemName.size() + value->size();
+    }
+    if (length > UINT32_MAX) {
+        return false;
+    }
+
+    uint64_t offset = loadDataEnd(map_);
+    if (offset + length > mapSize_) {
+        // Never shrink below what another process may already have grown to
+        struct stat status;
+        if (fstat(fd_, &status) != 0) {
+            return false;
+        }
+        uint64_t capacity = static_cast<uint64_t>(status.st_size);
+        if (capacity < offset + length) {
+            capacity = std::max<uint64_t>(capacity * 2, roundUp(offset + length, kGrowthStep));
+            if (ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+                return false;
+            }
+        }
+        if (!mapLocked(static_cast<size_t>(capacity))) {
+            closeLocked();
+            return false;
+        }
+    }
+
+    std::string hash = nameHash(itemName);
+    uint8_t* record = map_ + offset;
+    uint32_t recordLength = static_cast<uint32_t>(length);
+    std::memcpy(record, &recordLength, sizeof(recordLength));
+    record[4] = type;
+    std::memset(record + 5, 0, 3);
+    std::memcpy(record + 8, hash.data(), kHashSize);
+
+    if (type == kRecordPut) {
+        uint8_t aad[kAadSize];
+        buildAad(map_, type, record + 8, aad);
+        if (!seal(encryptionKey_, aad, itemName, *value, record + kRecordPrefix)) {
+            return false;
+        }
+    }
+
+    // The record must be on disk before the header points past it
+    if (!syncRange(map_, offset, length)) {
+        return false;
+    }
+    __atomic_store_n(&fileHeader(map_)->dataEnd, offset + length, __ATOMIC_RELEASE);
+    syncRange(map_, 0, sizeof(FileHeader));
+    return indexLocked(offset, offset + length);
+}
+
+// Copies the current records into a fresh file and renames it over the old
+// one; the caller holds the store lock
+long long FileKeystore::compactLocked() {
+    uint64_t oldEnd = loadDataEnd(map_);
+    uint64_t newEnd = sizeof(FileHeader) + liveBytes_;
+    size_t capacity = std::max(kGrowthStep, roundUp(newEnd, kGrowthStep));
+
+    std::string temporaryPath = path_ + ".compact";
+    int fd = open(temporaryPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return -1;
+    }
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(capacity)) == 0) {
+        mapped = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mapped == MAP_FAILED) {
+        close(fd);
+        unlink(temporaryPath.c_str());
+        return -1;
+    }
+    uint8_t* map = static_cast<uint8_t*>(mapped);
+
+    FileHeader header = *fileHeader(map_);
+    header.flags = 0;
+    header.dataEnd = newEnd;
+    std::memcpy(map, &header, sizeof(header));
+
+    // Keep file order so a replay of the new log sees the same history
+    std::vector<Entry*> live;
+    live.reserve(index_.size());
+    for (auto& item : index_) {
+        live.push_back(&item.second);
+    }
+    std::sort(live.begin(), live.end(), [](const Entry* a, const Entry* b) { return a->offset < b->offset; });
+
+    // Records are position independent, they are copied without re-sealing
+    std::vector<uint64_t> offsets;
+    offsets.reserve(live.size());
+    uint64_t offset = sizeof(FileHeader);
+    for (const Entry* entry : live) {
+        std::memcpy(map + offset, map_ + entry->offset, entry->length);
+        offsets.push_back(offset);
+        offset += entry->length;
+    }
+
+    if (msync(map, capacity, MS_SYNC) != 0 || fsync(fd) != 0 ||
+        rename(temporaryPath.c_str(), path_.c_str()) != 0) {
+        munmap(map, capacity);
+        close(fd);
+        unlink(temporaryPath.c_str());
+        return -1;
+    }
+
+    std::string directory = path_.substr(0, path_.find_last_of('/') + 1);
+    int directoryFd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (directoryFd >= 0) {
+        fsync(directoryFd);
+        close(directoryFd);
+    }
+
+    // Processes still mapping the old file reopen on their next call
+    __atomic_fetch_or(&fileHeader(map_)->flags, kFlagSuperseded, __ATOMIC_RELEASE);
+    syncRange(map_, 0, sizeof(FileHeader));
+
+    munmap(map_, mapSize_);
+    close(fd_);
+    map_ = map;
+    mapSize_ = capacity;
+    fd_ = fd;
+    for (size_t i = 0; i < live.size(); i++) {
+        live[i]->offset = offsets[i];
+    }
+    indexedEnd_ = newEnd;
+    return static_cast<long long>(oldEnd - newEnd);
+}
+
+// Checked on the JS thread before every call, so it does not open the file;
+// a store that cannot be opened fails its reads and writes instead
+bool FileKeystore::isAvailable() {
+    return true;
+}
+
+// Looks one item up in the index and decrypts it; the index is current
+KeyringReadResult FileKeystore::readLocked(const std::string& service, const std::string& account) {
+    KeyringReadResult result;
+    std::string itemName = service + '\0' + account;
+    auto it = index_.find(nameHash(itemName));
+    if (it == index_.end()) {
+        return result;
+    }
+
+    const uint8_t* record = map_ + it->second.offset;
+    uint8_t aad[kAadSize];
+    buildAad(map_, kRecordPut, record + 8, aad);
+
+    std::string value;
+    if (unseal(encryptionKey_, aad, record + kRecordPrefix, it->second.length - kRecordPrefix, itemName, value)) {
+        result.value = std::move(value);
+    } else {
+        result.failed = true;
+    }
+    return result;
+}
+
+void FileKeystore::get(const std::string& service, const std::string& account,
+                       KeyringExecutor::ReadCallback done) {
+    KeyringReadResult result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (refreshLocked()) {
+            result = readLocked(service, account);
+        } else {
+            result.failed = true;
+        }
+    }
+    done(std::move(result));
+}
+
+std::vector<KeyringReadResult> FileKeystore::getMany(const std::vector<KeyringItem>& items) {
+    std::vector<KeyringReadResult> results(items.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool ready = refreshLocked();
+    for (size_t i = 0; i < items.size(); i++) {
+        if (ready) {
+            results[i] = readLocked(items[i].service, items[i].account);
+        } else {
+            results[i].failed = true;
+        }
+    }
+    return results;
+}
+
+bool FileKeystore::set(const std::string& service, const std::string& account, const std::string& password) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!lockStoreLocked()) {
+        return false;
+    }
+
+    bool success = appendLocked(kRecordPut, service + '\0' + account, &password);
+    if (success && map_ != nullptr) {
+        uint64_t used = loadDataEnd(map_) - sizeof(FileHeader);
+        if (used > kAutoCompactBytes && used - liveBytes_ > liveBytes_) {
+            compactLocked();
+        }
+    }
+
+    unlockStoreLocked();
+    return success;
+}
+
+bool FileKeystore::removeMatching(const std::string& account, const std::string& servicePrefix,
+                                  const ServiceFilter& filter, std::vector<std::string>& removed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!lockStoreLocked()) {
+        return false;
+    }
+
+    // Collect first, appending deletions changes the index
+    bool success = true;
+    std::vector<std::string> matches;
+    for (const auto& item : index_) {
+        const uint8_t* record = map_ + item.second.offset;
+        uint8_t aad[kAadSize];
+        buildAad(map_, kRecordPut, record + 8, aad);
+
+        std::string itemName;
+        if (!unsealItemName(encryptionKey_, aad, record + kRecordPrefix, item.second.length - kRecordPrefix, itemName)) {
+            success = false;
+            continue;
+        }
+        size_t separator = itemName.find('\0');
+        if (separator == std::string::npos || itemName.compare(separator + 1, std::string::npos, account) != 0 ||
+            itemName.compare(0, servicePrefix.size(), servicePrefix) != 0 || separator < servicePrefix.size()) {
+            continue;
+        }
+        if (filter(itemName.substr(0, separator))) {
+            matches.push_back(std::move(itemName));
+        }
+    }
+
+    for (const std::string& itemName : matches) {
+        if (!appendLocked(kRecordDelete, itemName, nullptr)) {
+            success = false;
+            break;
+        }
+        removed.push_back(itemName.substr(0, itemName.find('\0')));
+    }
+
+    unlockStoreLocked();
+    return success;
+}
+
+long long FileKeystore::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!lockStoreLocked()) {
+        return -1;
+    }
+
+    long long reclaimed = compactLocked();
+    unlockStoreLocked();
+    return reclaimed;
+}
+
+FileKeystoreStats FileKeystore::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FileKeystoreStats stats;
+    if (refreshLocked()) {
+        stats.path = path_;
+        stats.fileBytes = loadDataEnd(map_);
+        stats.liveBytes = liveBytes_;
+        stats.records = index_.size();
+    }
+    return stats;
+}
+#endif
+
+} // namespace KeysGen
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "keyring_backend.h"
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace KeysGen {
+
+struct FileKeystoreStats {
+    std::string path;
+    uint64_t fileBytes = 0;   // bytes of the log in use, header included
+    uint64_t liveBytes = 0;   // bytes of records that are still current
+    size_t records = 0;
+};
+
+// Encrypted keystore for many services in a single append-only file. Every
+// record is sealed with AES-256-GCM and appended; the file is memory-mapped
+// and a hash index keyed by an HMAC of service and account points at the
+// current record, so a lookup is one hash probe plus one decryption straight
+// out of the mapping. Superseded records are reclaimed by compaction.
+//
+// The 256-bit master key lives in the OS keyring ("system" backend) under
+// the store's random id, or comes from KEYSTORE_MASTER_KEY (64 hex digits)
+// on hosts without one. Processes sharing the file serialize writes with a
+// lock file next to it and pick up each other's appends on the next call.
+// Calls take a file lock and may fetch the master key, so they run on the
+// keyring thread. POSIX only; unavailable on Windows.
+class FileKeystore : public KeyringBackend {
+public:
+    ~FileKeystore() override;
+
+    // The instance registered as the "file" backend
+    static std::shared_ptr<FileKeystore> shared();
+
+    const char* name() const override { return "file"; }
+    bool isAvailable() override;
+    bool usesKeyringThread() const override { return true; }
+
+    void get(const std::string& service, const std::string& account,
+             KeyringExecutor::ReadCallback done) override;
+    bool set(const std::string& service, const std::string& account, const std::string& password) override;
+    // Refreshes the index once for the whole batch
+    std::vector<KeyringReadResult> getMany(const std::vector<KeyringItem>& items) override;
+    // Decrypts every current record once to match names (the index only
+    // holds their hashes) and appends a deletion record per match
+    bool removeMatching(const std::string& account, const std::string& servicePrefix,
+                        const ServiceFilter& filter, std::vector<std::string>& removed) override;
+
+    // Switches to another file (empty = KEYSTORE_PATH or the default under
+    // the user's data directory); it is opened on the next call. Does not
+    // wait for a call in progress.
+    void setPath(const std::string& path);
+    // Rewrites the file with only the current records; returns the number of
+    // bytes reclaimed, or -1 if the store cannot be opened. Blocking, call it
+    // on the keyring thread.
+    long long compact();
+    FileKeystoreStats stats();
+
+private:
+    struct Entry {
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    bool refreshLocked();
+    bool lockStoreLocked();
+    void unlockStoreLocked();
+    bool openLocked();
+    void closeLocked();
+    bool mapLocked(size_t size);
+    bool indexLocked(uint64_t from, uint64_t to);
+    KeyringReadResult readLocked(const std::string& service, const std::string& account);
+    bool appendLocked(uint8_t type, const std::string& itemName, const std::string* value);
+    long long compactLocked();
+    std::string nameHash(const std::string& itemName) const;
+
+    std::mutex mutex_;
+    std::mutex pathMutex_;
+    std::string configuredPath_;
+    std::atomic<bool> pathChanged_{false};
+    std::string path_;
+    int fd_ = -1;
+    int lockFd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t mapSize_ = 0;
+    uint64_t indexedEnd_ = 0;
+    uint8_t encryptionKey_[32] = {};
+    uint8_t indexKey_[32] = {};
+    std::unordered_map<std::string, Entry> index_;
+    uint64_t liveBytes_ = 0;
+};
+
+} // namespace KeysGen
\ No newline at end of file
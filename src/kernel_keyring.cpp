@@ -0,0 +1,209 @@
+#include "kernel_keyring.h"
+#include <atomic>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/keyctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace KeysGen {
+
+static std::atomic<KernelKeyringScope> kernelKeyringScope{ KernelKeyringScope::User };
+
+void KernelKeyring::setScope(KernelKeyringScope scope) {
+    kernelKeyringScope.store(scope);
+}
+
+#ifdef __linux__
+
+// Possessor and owning user may view, read, write, search, link and setattr,
+// so other processes of the same user can read what this one stored
+static const unsigned long kKeyPermissions = 0x3f3f0000;
+
+static long keyctl(int operation, unsigned long arg2, unsigned long arg3 = 0,
+                   unsigned long arg4 = 0, unsigned long arg5 = 0) {
+    return syscall(SYS_keyctl, operation, arg2, arg3, arg4, arg5);
+}
+
+static const std::string kDescriptionPrefix = "keys_generator:";
+
+static std::string keyDescription(const std::string& service, const std::string& account) {
+    return kDescriptionPrefix + service + ":" + account;
+}
+
+// Serial of the keyring for the configured scope, or -1
+static long targetKeyring() {
+    switch (kernelKeyringScope.load()) {
+        case KernelKeyringScope::Session:
+            return KEY_SPEC_SESSION_KEYRING;
+        case KernelKeyringScope::Persistent:
+            // Links the persistent keyring into the process keyring so this
+            // process possesses it
+            return keyctl(KEYCTL_GET_PERSISTENT, static_cast<unsigned long>(-1), KEY_SPEC_PROCESS_KEYRING);
+        case KernelKeyringScope::User:
+        default:
+            return KEY_SPEC_USER_KEYRING;
+    }
+}
+
+bool KernelKeyring::isAvailable() {
+    long keyring = targetKeyring();
+    if (keyring == -1) {
+        return false;
+    }
+    // Fails with ENOSYS in kernels or sandboxes without key support
+    return keyctl(KEYCTL_GET_KEYRING_ID, static_cast<unsigned long>(keyring), 1) >= 0;
+}
+
+void KernelKeyring::get(const std::string& service, const std::string& account,
+                        KeyringExecutor::ReadCallback done) {
+    KeyringReadResult result;
+    result.value = read(service, account, result.failed);
+    done(std::move(result));
+}
+
+std::optional<std::string> KernelKeyring::read(const std::string& service, const std::string& account, bool& failed) {
+    failed = false;
+
+    long keyring = targetKeyring();
+    std::string description = keyDescription(service, account);
+    long key = keyring == -1 ? -1 : keyctl(KEYCTL_SEARCH, static_cast<unsigned long>(keyring),
+                                           reinterpret_cast<unsigned long>("user"),
+                                           reinterpret_cast<unsigned long>(description.c_str()), 0);
+    if (key < 0) {
+        failed = errno != ENOKEY && errno != EKEYEXPIRED && errno != EKEYREVOKED;
+        return std::nullopt;
+    }
+
+    // The payload may be replaced between sizing and reading, so retry
+    std::vector<char> buffer(4096);
+    while (true) {
+        long length = keyctl(KEYCTL_READ, static_cast<unsigned long>(key),
+                             reinterpret_cast<unsigned long>(buffer.data()), buffer.size());
+        if (length < 0) {
+            failed = true;
+            return std::nullopt;
+        }
+        if (static_cast<size_t>(length) <= buffer.size()) {
+            return std::string(buffer.data(), static_cast<size_t>(length));
+        }
+        buffer.resize(static_cast<size_t>(length));
+    }
+}
+
+bool KernelKeyring::set(const std::string& service, const std::string& account, const std::string& password) {
+    long keyring = targetKeyring();
+    if (keyring == -1) {
+        return false;
+    }
+
+    // add_key updates the payload in place when the description exists
+    std::string description = keyDescription(service, account);
+    long key = syscall(SYS_add_key, "user", description.c_str(), password.data(), password.size(), keyring);
+    if (key < 0) {
+        return false;
+    }
+
+    keyctl(KEYCTL_SETPERM, static_cast<unsigned long>(key), kKeyPermissions);
+    return true;
+}
+
+bool KernelKeyring::removeMatching(const std::string& account, const std::string& servicePrefix,
+                                   const ServiceFilter& filter, std::vector<std::string>& removed) {
+    long keyring = targetKeyring();
+    if (keyring == -1) {
+        return false;
+    }
+
+    // Serials of every key linked into the keyring
+    std::vector<int32_t> serials(256);
+    while (true) {
+        long length = keyctl(KEYCTL_READ, static_cast<unsigned long>(keyring),
+                             reinterpret_cast<unsigned long>(serials.data()), serials.size() * sizeof(int32_t));
+        if (length < 0) {
+            return false;
+        }
+        size_t count = static_cast<size_t>(length) / sizeof(int32_t);
+        if (count <= serials.size()) {
+            serials.resize(count);
+            break;
+        }
+        serials.resize(count);
+    }
+
+    std::string prefix = kDescriptionPrefix + servicePrefix;
+    std::string suffix = ":" + account;
+    bool success = true;
+    char buffer[4096];
+    for (int32_t serial : serials) {
+        // "type;uid;gid;perm;description"
+        long length = keyctl(KEYCTL_DESCRIBE, static_cast<unsigned long>(serial),
+                             reinterpret_cast<unsigned long>(buffer), sizeof(buffer));
+        if (length <= 0 || static_cast<size_t>(length) > sizeof(buffer)) {
+            continue;
+        }
+        std::string details(buffer, static_cast<size_t>(length) - 1);
+        size_t descriptionStart = 0;
+        for (int field = 0; field < 4 && descriptionStart != std::string::npos; field++) {
+            descriptionStart = details.find(';', descriptionStart);
+            if (descriptionStart != std::string::npos) {
+                descriptionStart++;
+            }
+        }
+        if (details.compare(0, 5, "user;") != 0 || descriptionStart == std::string::npos) {
+            continue;
+        }
+
+        std::string description = details.substr(descriptionStart);
+        if (description.size() < prefix.size() + suffix.size() ||
+            description.compare(0, prefix.size(), prefix) != 0 ||
+            description.compare(description.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        std::string service = description.substr(kDescriptionPrefix.size(),
+                                                 description.size() - kDescriptionPrefix.size() - suffix.size());
+        if (!filter(service)) {
+            continue;
+        }
+
+        // Invalidation drops the key from every keyring it is linked into
+        if (keyctl(KEYCTL_INVALIDATE, static_cast<unsigned long>(serial)) == 0 ||
+            keyctl(KEYCTL_UNLINK, static_cast<unsigned long>(serial), static_cast<unsigned long>(keyring)) == 0) {
+            removed.push_back(std::move(service));
+        } else {
+            success = false;
+        }
+    }
+    return success;
+}
+
+#else
+
+bool KernelKeyring::isAvailable() {
+    return false;
+}
+
+void KernelKeyring::get(const std::string&, const std::string&, KeyringExecutor::ReadCallback done) {
+    done(KeyringReadResult{});
+}
+
+std::optional<std::string> KernelKeyring::read(const std::string&, const std::string&, bool& failed) {
+    failed = false;
+    return std::nullopt;
+}
+
+bool KernelKeyring::set(const std::string&, const std::string&, const std::string&) {
+    return false;
+}
+
+bool KernelKeyring::removeMatching(const std::string&, const std::string&, const ServiceFilter&,
+                                   std::vector<std::string>&) {
+    return false;
+}
+
+#endif
+
+} // namespace KeysGen
\ No newline at end of file
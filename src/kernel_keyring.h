@@ -0,0 +1,40 @@
+#pragma once
+
+#include "keyring_backend.h"
+#include <optional>
+#include <string>
+
+namespace KeysGen {
+
+// Which kernel keyring items are stored in
+enum class KernelKeyringScope {
+    User,       // shared by all processes of the user while any of them runs
+    Session,    // the caller's login session
+    Persistent  // per-user keyring that outlives sessions (expires after days of disuse)
+};
+
+// Linux kernel key retention service (add_key/keyctl), called through raw
+// syscalls so no libkeyutils is needed. No daemon and no D-Bus hop: a read is
+// two syscalls. Items are "user" keys described as "keys_generator:<service>:<account>".
+class KernelKeyring : public KeyringBackend {
+public:
+    // Applies to every KernelKeyring instance
+    static void setScope(KernelKeyringScope scope);
+
+    const char* name() const override { return "kernel"; }
+    bool isAvailable() override;
+    bool usesKeyringThread() const override { return false; }
+
+    void get(const std::string& service, const std::string& account,
+             KeyringExecutor::ReadCallback done) override;
+    bool set(const std::string& service, const std::string& account, const std::string& password) override;
+    // Walks the scope's keyring once and invalidates matching keys
+    bool removeMatching(const std::string& account, const std::string& servicePrefix,
+                        const ServiceFilter& filter, std::vector<std::string>& removed) override;
+
+private:
+    // nullopt when the item does not exist; failed is set for other errors
+    static std::optional<std::string> read(const std::string& service, const std::string& account, bool& failed);
+};
+
+} // namespace KeysGen
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "key_pool.h"
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace KeysGen {
+
+namespace {
+
+struct PoolBucket {
+    KeyPoolConfig config;
+    std::deque<KeyPair> keys;
+    size_t inFlight = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t generated = 0;
+    bool refilling = false;
+    // Set when OpenSSL rejects the configuration; only configure() clears it
+    bool failed = false;
+};
+
+using PoolKey = std::pair<int, unsigned long>;
+
+struct PoolState {
+    std::mutex mutex;
+    std::condition_variable refillNeeded;
+    std::map<PoolKey, PoolBucket> buckets;
+    // Refill threads by id; a thread exits once its id is removed
+    std::map<size_t, std::thread> workers;
+    // Removed threads, joined once they have exited (or at shutdown)
+    std::map<size_t, std::thread> retired;
+    std::vector<size_t> exited;
+    size_t nextWorkerId = 0;
+    size_t refillThreads = 1;
+    bool stopping = false;
+};
+
+PoolState& state() {
+    static PoolState instance;
+    return instance;
+}
+
+// Hysteresis: start refilling below the low watermark, stop at the high one
+void updateRefillFlag(PoolBucket& bucket) {
+    if (bucket.failed) {
+        bucket.refilling = false;
+        return;
+    }
+
+    size_t pending = bucket.keys.size() + bucket.inFlight;
+    if (bucket.keys.size() < bucket.config.lowWatermark) {
+        bucket.refilling = true;
+    }
+    if (pending >= bucket.config.highWatermark) {
+        bucket.refilling = false;
+    }
+}
+
+PoolBucket* nextBucketToRefill(PoolState& s) {
+    for (auto& entry : s.buckets) {
+        PoolBucket& bucket = entry.second;
+        if (bucket.refilling && bucket.keys.size() + bucket.inFlight < bucket.config.highWatermark) {
+            return &bucket;
+        }
+    }
+    return nullptr;
+}
+
+void refillLoop(size_t id) {
+    PoolState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+
+    while (!s.stopping) {
+        if (s.workers.find(id) == s.workers.end()) {
+            s.exited.push_back(id);
+            return;
+        }
+
+        PoolBucket* bucket = nextBucketToRefill(s);
+        if (!bucket) {
+            s.refillNeeded.wait(lock);
+            continue;
+        }
+
+        PoolKey key(bucket->config.keyLength, bucket->config.publicExponent);
+        bucket->inFlight++;
+        lock.unlock();
+
+        auto keys = RSAGenerator::generateKeys(key.first, key.second);
+
+        lock.lock();
+        // The bucket may have been removed or reconfigured meanwhile
+        auto it = s.buckets.find(key);
+        if (it == s.buckets.end()) {
+            continue;
+        }
+
+        PoolBucket& current = it->second;
+        if (current.inFlight > 0) {
+            current.inFlight--;
+        }
+        if (keys.has_value()) {
+            current.keys.push_back(std::move(keys.value()));
+            current.generated++;
+        } else {
+            // Stop retrying a configuration OpenSSL rejects until it is
+            // configured again
+            current.failed = true;
+        }
+        updateRefillFlag(current);
+    }
+}
+
+// Must be called with the state mutex held. Joins retired threads that have
+// exited (they no longer need the mutex), then starts or retires threads
+// until refillThreads are running.
+void ensureWorkers(PoolState& s) {
+    for (size_t id : s.exited) {
+        auto it = s.retired.find(id);
+        if (it != s.retired.end()) {
+            it->second.join();
+            s.retired.erase(it);
+        }
+    }
+    s.exited.clear();
+
+    while (s.workers.size() < s.refillThreads) {
+        size_t id = s.nextWorkerId++;
+        s.workers.emplace(id, std::thread(refillLoop, id));
+    }
+    while (s.workers.size() > s.refillThreads) {
+        // Retire the newest; it exits after its current generation
+        auto last = std::prev(s.workers.end());
+        s.retired.emplace(last->first, std::move(last->second));
+        s.workers.erase(last);
+    }
+    s.refillNeeded.notify_all();
+}
+
+} // namespace
+
+void KeyPool::configure(const KeyPoolConfig& config) {
+    PoolState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    PoolKey key(config.keyLength, config.publicExponent);
+    if (config.highWatermark == 0) {
+        s.buckets.erase(key);
+        return;
+    }
+
+    PoolBucket& bucket = s.buckets[key];
+    bucket.config = config;
+    if (bucket.config.lowWatermark > bucket.config.highWatermark) {
+        bucket.config.lowWatermark = bucket.config.highWatermark;
+    }
+    while (bucket.keys.size() > bucket.config.highWatermark) {
+        bucket.keys.pop_front();
+    }
+
+    // A freshly configured pool fills up to its high watermark
+    bucket.failed = false;
+    bucket.refilling = true;
+    updateRefillFlag(bucket);
+
+    s.stopping = false;
+    ensureWorkers(s);
+    s.refillNeeded.notify_all();
+}
+
+void KeyPool::setRefillThreads(size_t count) {
+    PoolState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    s.refillThreads = count > 0 ? count : 1;
+    if (!s.buckets.empty() || s.workers.size() > s.refillThreads) {
+        ensureWorkers(s);
+    }
+}
+
+std::optional<KeyPair> KeyPool::tryTake(int keyLength, unsigned long publicExponent) {
+    PoolState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto it = s.buckets.find(PoolKey(keyLength, publicExponent));
+    if (it == s.buckets.end()) {
+        return std::nullopt;
+    }
+
+    PoolBucket& bucket = it->second;
+    if (bucket.keys.empty()) {
+        bucket.misses++;
+        if (!bucket.failed) {
+            bucket.refilling = true;
+            s.refillNeeded.notify_all();
+        }
+        return std::nullopt;
+    }
+
+    KeyPair keys = std::move(bucket.keys.front());
+    bucket.keys.pop_front();
+    bucket.hits++;
+
+    bool wasRefilling = bucket.refilling;
+    updateRefillFlag(bucket);
+    if (bucket.refilling && !wasRefilling) {
+        s.refillNeeded.notify_all();
+    }
+
+    return keys;
+}
+
+std::vector<KeyPoolStats> KeyPool::getStats() {
+    PoolState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    std::vector<KeyPoolStats> stats;
+    stats.reserve(s.buckets.size());
+    for (const auto& entry : s.buckets) {
+        const PoolBucket& bucket = entry.second;
+        KeyPoolStats item;
+        item.keyLength = bucket.config.keyLength;
+        item.publicExponent = bucket.config.publicExponent;
+        item.available = bucket.keys.size();
+        item.lowWatermark = bucket.config.lowWatermark;
+        item.highWatermark = bucket.config.highWatermark;
+        item.hits = bucket.hits;
+        item.misses = bucket.misses;
+        item.generated = bucket.generated;
+        item.refilling = bucket.refilling;
+        item.failed = bucket.failed;
+        stats.push_back(item);
+    }
+
+    return stats;
+}
+
+void KeyPool::shutdown() {
+    PoolState& s = state();
+    std::map<size_t, std::thread> workers;
+    std::map<size_t, std::thread> retired;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.stopping = true;
+        s.buckets.clear();
+        workers.swap(s.workers);
+        retired.swap(s.retired);
+        s.exited.clear();
+    }
+    s.refillNeeded.notify_all();
+
+    for (auto* threads : { &workers, &retired }) {
+        for (auto& worker : *threads) {
+            if (worker.second.joinable()) {
+                worker.second.join();
+            }
+        }
+    }
+}
+
+} // namespace KeysGen
\ No newline at end of file
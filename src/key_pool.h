@@ -0,0 +1,51 @@
+#pragma once
+
+#include "rsa_generator.h"
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace KeysGen {
+
+struct KeyPoolConfig {
+    int keyLength = 2048;
+    unsigned long publicExponent = RSAGenerator::kDefaultPublicExponent;
+    size_t lowWatermark = 2;   // refill starts when the pool drops below this
+    size_t highWatermark = 8;  // refill stops once the pool reaches this
+};
+
+struct KeyPoolStats {
+    int keyLength = 0;
+    unsigned long publicExponent = 0;
+    size_t available = 0;
+    size_t lowWatermark = 0;
+    size_t highWatermark = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t generated = 0;
+    bool refilling = false;
+    bool failed = false;  // generation failed; refill stops until reconfigured
+};
+
+// Keeps ready-made key pairs per (keyLength, publicExponent) in memory,
+// refilled by background threads between the low and high watermarks
+class KeyPool {
+public:
+    // Creates or updates the pool for config.keyLength/publicExponent.
+    // A highWatermark of 0 removes the pool.
+    // A configuration OpenSSL rejects stops refilling until configured again.
+    static void configure(const KeyPoolConfig& config);
+    // Starts or retires refill threads; a retired thread finishes the key it
+    // is generating first
+    static void setRefillThreads(size_t count);
+
+    // Pops a pooled pair, or nullopt if no pool exists or it is empty
+    static std::optional<KeyPair> tryTake(int keyLength, unsigned long publicExponent);
+
+    static std::vector<KeyPoolStats> getStats();
+
+    // Stops and joins the refill threads and drops all pooled keys
+    static void shutdown();
+};
+
+} // namespace KeysGen
\ No newline at end of file
@@ -1,5 +1,20 @@
 #include "keyring.h"
+#include "circuit_breaker.h"
+#include "deadline_timer.h"
+#include "file_keystore.h"
+#include "kernel_keyring.h"
+#include "memory_keyring.h"
+#include "platform_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -17,42 +32,600 @@
 
 namespace KeysGen {
 
-bool Keyring::isAvailable() {
+// Deadline for each backend call, 0 = wait indefinitely
+static std::atomic<int> keyringTimeoutMs{ 0 };
+
+static CircuitBreaker& keyringBreaker() {
+    static CircuitBreaker instance;
+    return instance;
+}
+
+// OS credential store: Credential Manager, Keychain or Secret Service
+class SystemKeyring : public KeyringBackend {
+public:
+    const char* name() const override { return "system"; }
+
+    bool isAvailable() override {
 #ifdef _WIN32
-    return true;
+        return true;
 #elif defined(__linux__) && defined(HAVE_LIBSECRET)
-    return true;
+        return true;
 #elif defined(__APPLE__)
-    return true;
+        return true;
 #else
-    return false;
+        return false;
 #endif
-}
+    }
 
-std::optional<std::string> Keyring::getPassword(const std::string& service, const std::string& account) {
+    bool usesKeyringThread() const override { return true; }
+
+    void get(const std::string& service, const std::string& account,
+             KeyringExecutor::ReadCallback done) override {
 #ifdef _WIN32
-    return getPasswordWindows(service, account);
+        done(KeyringReadResult{ Keyring::getPasswordWindows(service, account) });
 #elif defined(__linux__) && defined(HAVE_LIBSECRET)
-    return getPasswordLinux(service, account);
+        Keyring::getPasswordLinuxAsync(service, account, std::move(done));
 #elif defined(__APPLE__)
-    return getPasswordMacOS(service, account);
+        done(KeyringReadResult{ Keyring::getPasswordMacOS(service, account) });
 #else
-    return std::nullopt;
+        done(KeyringReadResult{});
 #endif
-}
+    }
 
-bool Keyring::setPassword(const std::string& service, const std::string& account, const std::string& password) {
+    bool removeMatching(const std::string& account, const std::string& servicePrefix,
+                        const ServiceFilter& filter, std::vector<std::string>& removed) override {
 #ifdef _WIN32
-    return setPasswordWindows(service, account, password);
+        return Keyring::removeMatchingWindows(account, servicePrefix, filter, removed);
 #elif defined(__linux__) && defined(HAVE_LIBSECRET)
-    return setPasswordLinux(service, account, password);
+        return Keyring::removeMatchingLinux(account, servicePrefix, filter, removed);
 #elif defined(__APPLE__)
-    return setPasswordMacOS(service, account, password);
+        return Keyring::removeMatchingMacOS(account, servicePrefix, filter, removed);
 #else
-    return false;
+        return false;
+#endif
+    }
+
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    std::vector<KeyringReadResult> getMany(const std::vector<KeyringItem>& items) override {
+        return Keyring::getPasswordsLinux(items);
+    }
+#endif
+
+    bool set(const std::string& service, const std::string& account, const std::string& password) override {
+#ifdef _WIN32
+        return Keyring::setPasswordWindows(service, account, password);
+#elif defined(__linux__) && defined(HAVE_LIBSECRET)
+        return Keyring::setPasswordLinux(service, account, password);
+#elif defined(__APPLE__)
+        return Keyring::setPasswordMacOS(service, account, password);
+#else
+        return false;
+#endif
+    }
+};
+
+// Registered backends by name and the active one
+struct BackendRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<KeyringBackend>> backends;
+    std::shared_ptr<KeyringBackend> active;
+
+    BackendRegistry() {
+        std::shared_ptr<KeyringBackend> builtIns[] = {
+            std::make_shared<SystemKeyring>(),
+            std::make_shared<KernelKeyring>(),
+            std::make_shared<MemoryKeyring>(),
+            FileKeystore::shared()
+        };
+        for (auto& backend : builtIns) {
+            backends[backend->name()] = backend;
+        }
+
+        // Linux builds without libsecret fall back to the kernel keyring
+#if defined(__linux__) && !defined(HAVE_LIBSECRET)
+        active = backends["kernel"];
+#else
+        active = backends["system"];
+#endif
+        auto configured = backends.find(PlatformUtils::getKeyringBackend());
+        if (configured != backends.end()) {
+            active = configured->second;
+        }
+    }
+};
+
+static BackendRegistry& backendRegistry() {
+    static BackendRegistry registry;
+    return registry;
+}
+
+static std::shared_ptr<KeyringBackend> activeBackend() {
+    BackendRegistry& registry = backendRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.active;
+}
+
+void Keyring::registerBackend(std::shared_ptr<KeyringBackend> backend) {
+    BackendRegistry& registry = backendRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.backends[backend->name()] = std::move(backend);
+}
+
+bool Keyring::setBackend(const std::string& name) {
+    BackendRegistry& registry = backendRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto it = registry.backends.find(name);
+        if (it == registry.backends.end()) {
+            return false;
+        }
+        if (registry.active == it->second) {
+            return true;
+        }
+        registry.active = it->second;
+    }
+
+    // Entries (and misses) of the previous store say nothing about this one
+    cache().clear();
+    return true;
+}
+
+// Reads from the backend on the keyring thread itself, where a queued read
+// would wait behind the running task forever. Asynchronous backends complete
+// through the thread's main context, which is pumped until they answer.
+static KeyringReadResult readOnKeyringThread(const std::shared_ptr<KeyringBackend>& backend,
+                                             const std::string& service, const std::string& account) {
+    auto result = std::make_shared<KeyringReadResult>();
+    auto finished = std::make_shared<std::atomic<bool>>(false);
+    result->failed = true;
+    backend->get(service, account, [result, finished](KeyringReadResult answer) {
+        *result = std::move(answer);
+        finished->store(true);
+    });
+    KeyringExecutor::instance().pumpUntil([&finished]() { return finished->load(); });
+    return *result;
+}
+
+static std::shared_ptr<KeyringBackend> findBackend(const std::string& name) {
+    BackendRegistry& registry = backendRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.backends.find(name);
+    return it != registry.backends.end() ? it->second : nullptr;
+}
+
+std::string Keyring::getBackendName() {
+    return activeBackend()->name();
+}
+
+bool Keyring::isAvailable() {
+    return activeBackend()->isAvailable();
+}
+
+std::optional<std::string> Keyring::getPasswordFrom(const std::string& backendName,
+                                                    const std::string& service, const std::string& account) {
+    std::shared_ptr<KeyringBackend> backend = findBackend(backendName);
+    if (!backend || !backend->isAvailable()) {
+        return std::nullopt;
+    }
+
+    if (backend->usesKeyringThread() && KeyringExecutor::instance().onExecutorThread()) {
+        return readOnKeyringThread(backend, service, account).value;
+    }
+
+    // Shared with the backend, which may answer after a timeout
+    auto promise = std::make_shared<std::promise<KeyringReadResult>>();
+    std::future<KeyringReadResult> future = promise->get_future();
+    KeyringExecutor::ReadCallback complete = [promise](KeyringReadResult result) {
+        promise->set_value(std::move(result));
+    };
+
+    if (backend->usesKeyringThread()) {
+        KeyringExecutor::instance().readAsync(
+            service + '\0' + account,
+            [backend, service, account](KeyringExecutor::ReadCallback done) {
+                backend->get(service, account, std::move(done));
+            },
+            std::move(complete));
+    } else {
+        backend->get(service, account, std::move(complete));
+    }
+
+    int timeoutMs = keyringTimeoutMs.load();
+    if (timeoutMs > 0 && future.wait_for(std::chrono::milliseconds(timeoutMs)) != std::future_status::ready) {
+        return std::nullopt;
+    }
+    return future.get().value;
+}
+
+bool Keyring::setPasswordIn(const std::string& backendName, const std::string& service,
+                            const std::string& account, const std::string& password) {
+    std::shared_ptr<KeyringBackend> backend = findBackend(backendName);
+    if (!backend || !backend->isAvailable()) {
+        return false;
+    }
+
+    if (!backend->usesKeyringThread()) {
+        return backend->set(service, account, password);
+    }
+    return KeyringExecutor::instance().write(service + '\0' + account, [backend, service, account, password]() {
+        return backend->set(service, account, password);
+    });
+}
+
+KeyringCache& Keyring::cache() {
+    static KeyringCache instance;
+    return instance;
+}
+
+void Keyring::configureCache(size_t maxEntries, long long ttlMs) {
+    cache().configure(maxEntries, ttlMs);
+}
+
+void Keyring::configureNegativeCache(long long ttlMs) {
+    cache().configureNegative(ttlMs);
+}
+
+void Keyring::invalidateCache(const std::string& service, const std::string& account) {
+    cache().invalidate(service, account);
+}
+
+void Keyring::clearCache() {
+    cache().clear();
+}
+
+KeyringCacheStats Keyring::getCacheStats() {
+    return cache().stats();
+}
+
+std::optional<std::string> Keyring::getPassword(const std::string& service, const std::string& account) {
+    return lookup(service, account).value;
+}
+
+KeyringReadResult Keyring::lookup(const std::string& service, const std::string& account) {
+    std::shared_ptr<KeyringBackend> backend = activeBackend();
+    if (backend->usesKeyringThread() && KeyringExecutor::instance().onExecutorThread()) {
+        // Waiting for lookupAsync here would block the thread that has to
+        // answer it
+        KeyringReadResult result;
+        if (cache().enabled()) {
+            result.value = cache().get(service, account);
+            if (result.value.has_value()) {
+                return result;
+            }
+        }
+        uint64_t generation = cache().generation(service, account);
+        result = readOnKeyringThread(backend, service, account);
+        rememberLookup(service, account, result, generation);
+        return result;
+    }
+
+    std::promise<KeyringReadResult> promise;
+    std::future<KeyringReadResult> future = promise.get_future();
+    lookupAsync(service, account, [&promise](KeyringReadResult result) {
+        promise.set_value(std::move(result));
+    });
+    return future.get();
+}
+
+// A caller waiting on the keyring thread. Settled exactly once, either by
+// the backend or by its deadline, whichever comes first.
+template <typename Callback>
+struct PendingCall {
+    std::atomic<bool> settled{ false };
+    std::atomic<uint64_t> deadline{ 0 };
+    Callback done;
+
+    bool settle() {
+        if (settled.exchange(true)) {
+            return false;
+        }
+        uint64_t timer = deadline.load();
+        if (timer != 0) {
+            DeadlineTimer::shared().cancel(timer);
+        }
+        return true;
+    }
+
+    // Whoever settled the call runs done through this, so the call stops
+    // keeping done's captures alive (a cancellation may still hold the call)
+    Callback take() {
+        Callback taken = std::move(done);
+        done = nullptr;
+        return taken;
+    }
+};
+
+// Settles call with `timedOutValue` once the keyring timeout elapses
+template <typename Call, typename Value>
+static void armDeadline(const std::shared_ptr<Call>& call, Value timedOutValue) {
+    int timeoutMs = keyringTimeoutMs.load();
+    if (timeoutMs <= 0) {
+        return;
+    }
+
+    call->deadline.store(DeadlineTimer::shared().schedule(std::chrono::milliseconds(timeoutMs), [call, timedOutValue]() {
+        if (!call->settled.exchange(true)) {
+            keyringBreaker().recordTimeout();
+            call->take()(timedOutValue);
+        }
+    }));
+}
+
+// Records a backend answer in the caches unless the item was written since
+// the read started; failures are not misses
+void Keyring::rememberLookup(const std::string& service, const std::string& account,
+                             const KeyringReadResult& result, uint64_t generation) {
+    if (result.value.has_value()) {
+        if (cache().enabled()) {
+            cache().put(service, account, result.value.value(), generation);
+        }
+    } else if (!result.failed && cache().negativeEnabled()) {
+        cache().putMissing(service, account, generation);
+    }
+}
+
+void Keyring::getPasswordAsync(const std::string& service, const std::string& account, PasswordCallback done,
+                               const CancellationPtr& cancellation) {
+    lookupAsync(service, account, [done = std::move(done)](KeyringReadResult result) {
+        done(std::move(result.value));
+    }, cancellation);
+}
+
+// A read the backend could not answer: an error, a timeout or an open breaker
+static KeyringReadResult failedRead(bool timedOut) {
+    KeyringReadResult result;
+    result.failed = true;
+    result.timedOut = timedOut;
+    return result;
+}
+
+void Keyring::lookupAsync(const std::string& service, const std::string& account, KeyringExecutor::ReadCallback done,
+                          const CancellationPtr& cancellation) {
+    if (cache().enabled()) {
+        KeyringReadResult cached;
+        cached.value = cache().get(service, account);
+        if (cached.value.has_value()) {
+            done(std::move(cached));
+            return;
+        }
+    }
+
+    if (cache().negativeEnabled() && cache().isKnownMissing(service, account)) {
+        done(KeyringReadResult{});
+        return;
+    }
+
+    uint64_t generation = cache().generation(service, account);
+    std::shared_ptr<KeyringBackend> backend = activeBackend();
+    if (!backend->usesKeyringThread()) {
+        // Cheaper than a hop to the keyring thread
+        backend->get(service, account, [service, account, generation, done = std::move(done)](KeyringReadResult result) {
+            rememberLookup(service, account, result, generation);
+            done(std::move(result));
+        });
+        return;
+    }
+
+    bool trial = false;
+    if (!keyringBreaker().allow(trial)) {
+        // The backend keeps timing out; fail fast until the cooldown passed
+        done(failedRead(false));
+        return;
+    }
+
+    auto call = std::make_shared<PendingCall<KeyringExecutor::ReadCallback>>();
+    call->done = std::move(done);
+    armDeadline(call, failedRead(true));
+
+    // Backend calls are serialized on the keyring thread; identical reads
+    // that are queued or in flight share one lookup
+    KeyringExecutor::instance().readAsync(
+        service + '\0' + account,
+        [backend, service, account](KeyringExecutor::ReadCallback complete) {
+            backend->get(service, account, std::move(complete));
+        },
+        [service, account, generation, call](KeyringReadResult result) {
+            // Cache even a late answer, unless a write replaced it meanwhile
+            rememberLookup(service, account, result, generation);
+
+            if (!call->settle()) {
+                return;
+            }
+            if (result.timedOut) {
+                keyringBreaker().recordTimeout();
+            } else {
+                keyringBreaker().recordSuccess();
+            }
+            call->take()(std::move(result));
+        },
+        cancellation);
+
+    if (cancellation) {
+        // The caller stops waiting now; the executor drops the backend call
+        // once no other caller waits for it
+        cancellation->onCancel([call, trial]() {
+            if (call->settle()) {
+                if (trial) {
+                    keyringBreaker().releaseTrial();
+                }
+                call->take()(failedRead(false));
+            }
+        });
+    }
+}
+
+std::vector<std::optional<std::string>> Keyring::getPasswords(const std::vector<KeyringItem>& items) {
+    std::vector<KeyringReadResult> results = lookupMany(items);
+    std::vector<std::optional<std::string>> values(results.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        values[i] = std::move(results[i].value);
+    }
+    return values;
+}
+
+std::vector<KeyringReadResult> Keyring::lookupMany(const std::vector<KeyringItem>& items) {
+    std::vector<KeyringReadResult> values(items.size());
+    std::vector<KeyringItem> missing;
+    std::vector<size_t> missingIndexes;
+    std::vector<uint64_t> generations;
+    for (size_t i = 0; i < items.size(); i++) {
+        const KeyringItem& item = items[i];
+        if (cache().enabled()) {
+            values[i].value = cache().get(item.service, item.account);
+            if (values[i].value.has_value()) {
+                continue;
+            }
+        }
+        if (cache().negativeEnabled() && cache().isKnownMissing(item.service, item.account)) {
+            continue;
+        }
+        missing.push_back(item);
+        missingIndexes.push_back(i);
+        generations.push_back(cache().generation(item.service, item.account));
+    }
+    if (missing.empty()) {
+        return values;
+    }
+
+    std::shared_ptr<KeyringBackend> backend = activeBackend();
+    std::vector<KeyringReadResult> results;
+    if (!backend->usesKeyringThread()) {
+        results = backend->getMany(missing);
+    } else {
+        if (!keyringBreaker().allow()) {
+            for (size_t index : missingIndexes) {
+                values[index] = failedRead(false);
+            }
+            return values;
+        }
+
+        // One task on the keyring thread for the whole batch
+        KeyringExecutor::instance().run([&]() { results = backend->getMany(missing); });
+        bool timedOut = std::any_of(results.begin(), results.end(),
+                                    [](const KeyringReadResult& result) { return result.timedOut; });
+        if (timedOut) {
+            keyringBreaker().recordTimeout();
+        } else {
+            keyringBreaker().recordSuccess();
+        }
+    }
+
+    for (size_t i = 0; i < missing.size(); i++) {
+        if (i >= results.size()) {
+            values[missingIndexes[i]] = failedRead(false);
+            continue;
+        }
+        rememberLookup(missing[i].service, missing[i].account, results[i], generations[i]);
+        values[missingIndexes[i]] = std::move(results[i]);
+    }
+    return values;
+}
+
+int Keyring::deletePasswords(const std::string& account, const std::string& servicePrefix, const ServiceFilter& filter) {
+    std::shared_ptr<KeyringBackend> backend = activeBackend();
+    std::vector<std::string> removed;
+    bool success = false;
+    if (!backend->usesKeyringThread()) {
+        success = backend->removeMatching(account, servicePrefix, filter, removed);
+    } else {
+        if (!keyringBreaker().allow()) {
+            return -1;
+        }
+        KeyringExecutor::instance().run([&]() {
+            success = backend->removeMatching(account, servicePrefix, filter, removed);
+        });
+    }
+
+    for (const std::string& service : removed) {
+        cache().invalidate(service, account);
+    }
+    return success ? static_cast<int>(removed.size()) : -1;
+}
+
+void Keyring::setBatchWindow(int windowMs) {
+    KeyringExecutor::instance().setBatchWindow(std::chrono::milliseconds(windowMs));
+}
+
+void Keyring::configureTimeouts(int timeoutMs, int breakerThreshold, int breakerCooldownMs) {
+    if (timeoutMs >= 0) {
+        keyringTimeoutMs.store(timeoutMs);
+    }
+    keyringBreaker().configure(breakerThreshold, std::chrono::milliseconds(breakerCooldownMs));
+}
+
+bool Keyring::isCircuitOpen() {
+    return keyringBreaker().isOpen();
+}
+
+void Keyring::shutdown() {
+    KeyringExecutor::instance().shutdown();
+    DeadlineTimer::shared().shutdown();
+}
+
+int Keyring::migrateLegacyItems() {
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    if (std::string(activeBackend()->name()) != "system") {
+        return 0;
+    }
+
+    int migrated = 0;
+    KeyringExecutor::instance().run([&]() { migrated = migrateLegacyItemsLinux(); });
+    return migrated;
+#else
+    // Only the Linux backend ever stored items under another schema
+    return 0;
 #endif
 }
 
+bool Keyring::setPassword(const std::string& service, const std::string& account, const std::string& password) {
+    // Completes inline on the keyring thread, so waiting is safe there too
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    setPasswordAsync(service, account, password, [promise](bool success) { promise->set_value(success); });
+    return future.get();
+}
+
+void Keyring::setPasswordAsync(const std::string& service, const std::string& account, const std::string& password,
+                               std::function<void(bool)> done) {
+    // Drop the old value first so a failed write cannot leave it cached
+    cache().invalidate(service, account);
+
+    std::shared_ptr<KeyringBackend> backend = activeBackend();
+    if (!backend->usesKeyringThread()) {
+        bool success = backend->set(service, account, password);
+        if (success) {
+            cache().store(service, account, password);
+        }
+        done(success);
+        return;
+    }
+
+    if (!keyringBreaker().allow()) {
+        done(false);
+        return;
+    }
+
+    auto call = std::make_shared<PendingCall<std::function<void(bool)>>>();
+    call->done = std::move(done);
+    armDeadline(call, false);
+
+    // Captured by value: after a timeout the write outlives this frame
+    KeyringExecutor::instance().writeAsync(
+        service + '\0' + account,
+        [backend, service, account, password]() {
+            return backend->set(service, account, password);
+        },
+        [service, account, password, call](bool success) {
+            if (success) {
+                cache().store(service, account, password);
+            }
+            if (call->settle()) {
+                keyringBreaker().recordSuccess();
+                call->take()(success);
+            }
+        });
+}
+
 #ifdef _WIN32
 std::optional<std::string> Keyring::getPasswordWindows(const std::string& service, const std::string& account) {
     PCREDENTIALW credential = nullptr;
@@ -89,6 +662,46 @@ bool Keyring::setPasswordWindows(const std::string& service, const std::string&
 
     return CredWriteW(&credential, 0) != 0;
 }
+
+// Items are keyed by target name only (the account is not part of it), so
+// the prefix becomes a CredEnumerate filter
+bool Keyring::removeMatchingWindows(const std::string& account, const std::string& servicePrefix,
+                                    const ServiceFilter& filter, std::vector<std::string>& removed) {
+    std::string pattern = servicePrefix + "*";
+    int widePatternSize = MultiByteToWideChar(CP_UTF8, 0, pattern.c_str(), -1, nullptr, 0);
+    std::wstring widePattern(widePatternSize, 0);
+    MultiByteToWideChar(CP_UTF8, 0, pattern.c_str(), -1, &widePattern[0], widePatternSize);
+
+    DWORD count = 0;
+    PCREDENTIALW* credentials = nullptr;
+    if (!CredEnumerateW(widePattern.c_str(), 0, &count, &credentials)) {
+        return GetLastError() == ERROR_NOT_FOUND;
+    }
+
+    bool success = true;
+    for (DWORD i = 0; i < count; i++) {
+        if (credentials[i]->Type != CRED_TYPE_GENERIC) {
+            continue;
+        }
+
+        LPCWSTR target = credentials[i]->TargetName;
+        int serviceSize = WideCharToMultiByte(CP_UTF8, 0, target, -1, nullptr, 0, nullptr, nullptr);
+        std::string service(serviceSize > 0 ? serviceSize - 1 : 0, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, target, -1, &service[0], serviceSize, nullptr, nullptr);
+        if (!filter(service)) {
+            continue;
+        }
+
+        if (CredDeleteW(target, CRED_TYPE_GENERIC, 0)) {
+            removed.push_back(std::move(service));
+        } else {
+            success = false;
+        }
+    }
+
+    CredFree(credentials);
+    return success;
+}
 #endif
 
 #ifdef __linux__
@@ -110,46 +723,596 @@ static const SecretSchema* get_keyring_schema(void) {
     return &schema;
 }
 
-std::optional<std::string> Keyring::getPasswordLinux(const std::string& service, const std::string& account) {
-    GError* error = nullptr;
+// Long-lived Secret Service proxy with an open session, shared by all calls
+// so each lookup is a single D-Bus method call instead of a session setup
+static std::mutex secretServiceMutex;
+static SecretService* secretService = nullptr;
 
-    // Try the Python-compatible schema first (Generic)
-    gchar* password = secret_password_lookup_sync(
-        get_keyring_schema(),
-        nullptr,
-        &error,
-        "service", service.c_str(),
-        "username", account.c_str(),
+// Returns a new reference to the shared proxy, connecting on first use
+static SecretService* acquireSecretService(GCancellable* cancellable, GError** error) {
+    std::lock_guard<std::mutex> lock(secretServiceMutex);
+    if (!secretService) {
+        secretService = secret_service_get_sync(SECRET_SERVICE_OPEN_SESSION, cancellable, error);
+        if (!secretService) {
+            return nullptr;
+        }
+    }
+    return static_cast<SecretService*>(g_object_ref(secretService));
+}
+
+// Forgets a proxy whose connection dropped so the next call reconnects
+static void dropSecretService(SecretService* stale) {
+    std::lock_guard<std::mutex> lock(secretServiceMutex);
+    if (secretService == stale) {
+        g_object_unref(secretService);
+        secretService = nullptr;
+        // Also drop libsecret's own shared instance
+        secret_service_disconnect();
+    }
+}
+
+static bool isConnectionError(const GError* error) {
+    return error->domain == G_DBUS_ERROR || g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CLOSED);
+}
+
+using CancellablePtr = std::shared_ptr<GCancellable>;
+
+// Cancellable that the deadline timer trips once the keyring timeout
+// elapses, aborting the D-Bus call even while the keyring thread is blocked
+// in it. Returns the timer id (0 when no timeout is configured).
+static uint64_t armCancellable(const CancellablePtr& cancellable) {
+    int timeoutMs = keyringTimeoutMs.load();
+    if (timeoutMs <= 0) {
+        return 0;
+    }
+
+    return DeadlineTimer::shared().schedule(std::chrono::milliseconds(timeoutMs), [cancellable]() {
+        g_cancellable_cancel(cancellable.get());
+    });
+}
+
+static CancellablePtr newCancellable() {
+    return CancellablePtr(g_cancellable_new(), g_object_unref);
+}
+
+// Runs op against the shared proxy, reconnecting and retrying once when the
+// bus connection was lost
+template <typename Op>
+static bool withSecretService(Op op, GCancellable* cancellable, GError** error) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        GError* localError = nullptr;
+        SecretService* service = acquireSecretService(cancellable, &localError);
+        if (!service) {
+            g_propagate_error(error, localError);
+            return false;
+        }
+
+        bool success = op(service, &localError);
+        if (!localError || attempt == 1 || !isConnectionError(localError)) {
+            g_object_unref(service);
+            if (localError) {
+                g_propagate_error(error, localError);
+            }
+            return success;
+        }
+
+        g_error_free(localError);
+        dropSecretService(service);
+        g_object_unref(service);
+    }
+    return false;
+}
+
+// Schema each item was last found under, so legacy items take one lookup.
+// Only items last found under the network schema try the other schema after
+// a plain miss; everything else falls back only when the lookup fails, as
+// the original lookup did.
+enum class ResolvedSchema {
+    Generic,
+    Network
+};
+
+static std::mutex resolvedSchemaMutex;
+static std::unordered_map<std::string, ResolvedSchema> resolvedSchemas;
+
+static std::string resolvedSchemaKey(const std::string& service, const std::string& account) {
+    return service + '\0' + account;
+}
+
+static std::optional<ResolvedSchema> getResolvedSchema(const std::string& service, const std::string& account) {
+    std::lock_guard<std::mutex> lock(resolvedSchemaMutex);
+    auto it = resolvedSchemas.find(resolvedSchemaKey(service, account));
+    if (it == resolvedSchemas.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+static void setResolvedSchema(const std::string& service, const std::string& account, ResolvedSchema schema) {
+    std::lock_guard<std::mutex> lock(resolvedSchemaMutex);
+    resolvedSchemas[resolvedSchemaKey(service, account)] = schema;
+}
+
+// Attributes identifying service/account under the given schema
+static GHashTable* buildLookupAttributes(ResolvedSchema schema, const std::string& service,
+                                         const std::string& account, const SecretSchema** secretSchema) {
+    if (schema == ResolvedSchema::Generic) {
+        // Python-compatible schema (Generic)
+        *secretSchema = get_keyring_schema();
+        return secret_attributes_build(
+            *secretSchema,
+            "service", service.c_str(),
+            "username", account.c_str(),
+            nullptr
+        );
+    }
+
+    // Network schema used by earlier versions
+    *secretSchema = SECRET_SCHEMA_COMPAT_NETWORK;
+    return secret_attributes_build(
+        *secretSchema,
+        "server", service.c_str(),
+        "user", account.c_str(),
         nullptr
     );
+}
+
+static std::vector<ResolvedSchema> lookupOrder(const std::string& service, const std::string& account,
+                                               bool& fallbackOnMiss) {
+    auto known = getResolvedSchema(service, account);
+    fallbackOnMiss = false;
+    if (known == ResolvedSchema::Generic) {
+        return { ResolvedSchema::Generic };
+    }
+    if (known == ResolvedSchema::Network) {
+        // Another process may have migrated it since
+        fallbackOnMiss = true;
+        return { ResolvedSchema::Network, ResolvedSchema::Generic };
+    }
+    // Unknown items try Generic, and the legacy network schema if that fails
+    return { ResolvedSchema::Generic, ResolvedSchema::Network };
+}
+
+// One asynchronous lookup walking its schema order; it lives until done runs
+struct AsyncLookup {
+    std::string service;
+    std::string account;
+    std::vector<ResolvedSchema> order;
+    size_t index = 0;
+    bool fallbackOnMiss = false;  // a plain miss moves on to the next schema
+    bool reconnected = false;
+    bool failed = false;
+    SecretService* proxy = nullptr;
+    GHashTable* attributes = nullptr;
+    CancellablePtr cancellable;
+    uint64_t deadline = 0;
+    KeyringExecutor::ReadCallback done;
+};
+
+static void finishLookup(AsyncLookup* lookup, std::optional<std::string> password) {
+    if (lookup->deadline != 0) {
+        DeadlineTimer::shared().cancel(lookup->deadline);
+    }
+
+    KeyringReadResult result;
+    result.value = std::move(password);
+    result.timedOut = g_cancellable_is_cancelled(lookup->cancellable.get()) != FALSE;
+    result.failed = !result.value.has_value() && (lookup->failed || result.timedOut);
+    lookup->done(std::move(result));
+    delete lookup;
+}
+
+static void startLookup(AsyncLookup* lookup);
+
+static void onLookupFinished(GObject*, GAsyncResult* result, gpointer userData) {
+    auto* lookup = static_cast<AsyncLookup*>(userData);
+    GError* error = nullptr;
+    SecretValue* value = secret_service_lookup_finish(lookup->proxy, result, &error);
+
+    SecretService* proxy = lookup->proxy;
+    lookup->proxy = nullptr;
+    g_hash_table_unref(lookup->attributes);
+    lookup->attributes = nullptr;
+
+    if (value) {
+        gsize length = 0;
+        const gchar* data = secret_value_get(value, &length);
+        std::string password(data, length);
+        secret_value_unref(value);
+        g_object_unref(proxy);
+
+        setResolvedSchema(lookup->service, lookup->account, lookup->order[lookup->index]);
+        finishLookup(lookup, std::move(password));
+        return;
+    }
 
     if (error) {
+        bool cancelled = g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+        bool reconnect = !cancelled && !lookup->reconnected && isConnectionError(error);
+        lookup->failed = true;
         g_error_free(error);
-        error = nullptr;
+        if (cancelled) {
+            g_object_unref(proxy);
+            finishLookup(lookup, std::nullopt);
+            return;
+        }
+        if (reconnect) {
+            // The bus connection was lost; retry this schema once on a new one
+            lookup->reconnected = true;
+            dropSecretService(proxy);
+            g_object_unref(proxy);
+            startLookup(lookup);
+            return;
+        }
+    } else if (!lookup->fallbackOnMiss) {
+        // Not found: the next schema is only worth a round trip on errors
+        g_object_unref(proxy);
+        finishLookup(lookup, std::nullopt);
+        return;
+    }
+
+    g_object_unref(proxy);
+    lookup->index++;
+    startLookup(lookup);
+}
 
-        // Fallback: try network schema for backwards compatibility
-        password = secret_password_lookup_sync(
+static void startLookup(AsyncLookup* lookup) {
+    if (lookup->index >= lookup->order.size()) {
+        finishLookup(lookup, std::nullopt);
+        return;
+    }
+
+    GError* error = nullptr;
+    lookup->proxy = acquireSecretService(lookup->cancellable.get(), &error);
+    if (!lookup->proxy) {
+        if (error) {
+            g_error_free(error);
+        }
+        lookup->failed = true;
+        finishLookup(lookup, std::nullopt);
+        return;
+    }
+
+    const SecretSchema* schema = nullptr;
+    lookup->attributes = buildLookupAttributes(lookup->order[lookup->index], lookup->service, lookup->account, &schema);
+    // Completes on the keyring thread's main context without blocking it
+    secret_service_lookup(lookup->proxy, schema, lookup->attributes, lookup->cancellable.get(), onLookupFinished, lookup);
+}
+
+void Keyring::getPasswordLinuxAsync(const std::string& service, const std::string& account,
+                                    KeyringExecutor::ReadCallback done) {
+    auto* lookup = new AsyncLookup();
+    lookup->service = service;
+    lookup->account = account;
+    lookup->order = lookupOrder(service, account, lookup->fallbackOnMiss);
+    lookup->cancellable = newCancellable();
+    lookup->deadline = armCancellable(lookup->cancellable);
+    lookup->done = std::move(done);
+    // Callers that all gave up cancel the D-Bus call like a timeout would
+    KeyringExecutor::instance().onAbandon([cancellable = lookup->cancellable]() {
+        g_cancellable_cancel(cancellable.get());
+    });
+    startLookup(lookup);
+}
+
+// Every item of `account` under the schema, in one D-Bus call. Secrets are
+// not loaded: other applications' items may share the account.
+static GList* searchAccountItems(ResolvedSchema schema, const std::string& account,
+                                 GCancellable* cancellable, GError** error) {
+    const SecretSchema* secretSchema = schema == ResolvedSchema::Generic ? get_keyring_schema() : SECRET_SCHEMA_COMPAT_NETWORK;
+    GHashTable* attributes = schema == ResolvedSchema::Generic
+        ? secret_attributes_build(secretSchema, "username", account.c_str(), nullptr)
+        : secret_attributes_build(secretSchema, "user", account.c_str(), nullptr);
+
+    GList* items = nullptr;
+    withSecretService([&](SecretService* proxy, GError** opError) {
+        items = secret_service_search_sync(
+            proxy,
+            secretSchema,
+            attributes,
+            static_cast<SecretSearchFlags>(SECRET_SEARCH_ALL | SECRET_SEARCH_UNLOCK),
+            cancellable,
+            opError
+        );
+        return items != nullptr;
+    }, cancellable, error);
+    g_hash_table_unref(attributes);
+    return items;
+}
+
+// Answers a batch with one search per account (all items share "key"), plus
+// one over the legacy network schema for unanswered items last found there
+std::vector<KeyringReadResult> Keyring::getPasswordsLinux(const std::vector<KeyringItem>& items) {
+    std::vector<KeyringReadResult> results(items.size());
+
+    // Requested item indexes by account, then service
+    std::unordered_map<std::string, std::unordered_map<std::string, std::vector<size_t>>> wanted;
+    for (size_t i = 0; i < items.size(); i++) {
+        wanted[items[i].account][items[i].service].push_back(i);
+    }
+
+    CancellablePtr cancellable = newCancellable();
+    uint64_t deadline = armCancellable(cancellable);
+
+    for (auto& account : wanted) {
+        auto& services = account.second;
+        for (ResolvedSchema schema : { ResolvedSchema::Generic, ResolvedSchema::Network }) {
+            if (schema == ResolvedSchema::Network) {
+                // Like single lookups, plain misses only fall back for items
+                // known to be legacy
+                for (auto it = services.begin(); it != services.end();) {
+                    bool legacy = getResolvedSchema(it->first, account.first) == ResolvedSchema::Network;
+                    it = legacy ? std::next(it) : services.erase(it);
+                }
+            }
+            if (services.empty()) {
+                break;
+            }
+
+            GError* error = nullptr;
+            GList* found = searchAccountItems(schema, account.first, cancellable.get(), &error);
+            if (error) {
+                // Whatever is still unanswered failed rather than missed
+                bool timedOut = g_cancellable_is_cancelled(cancellable.get()) != FALSE;
+                g_error_free(error);
+                for (auto& service : services) {
+                    for (size_t index : service.second) {
+                        results[index].failed = true;
+                        results[index].timedOut = timedOut;
+                    }
+                }
+                services.clear();
+                break;
+            }
+
+            // Match on attributes, then load the secrets of the requested
+            // items only, together in one more call
+            std::unordered_map<std::string, SecretItem*> matches;
+            for (GList* node = found; node != nullptr; node = node->next) {
+                SecretItem* item = static_cast<SecretItem*>(node->data);
+                GHashTable* attributes = secret_item_get_attributes(item);
+                const char* name = static_cast<const char*>(
+                    g_hash_table_lookup(attributes, schema == ResolvedSchema::Generic ? "service" : "server"));
+                if (name && services.count(name) != 0) {
+                    matches.emplace(name, item);
+                }
+                g_hash_table_unref(attributes);
+            }
+
+            GList* matched = nullptr;
+            for (const auto& match : matches) {
+                matched = g_list_prepend(matched, match.second);
+            }
+            GError* loadError = nullptr;
+            if (matched != nullptr && !secret_item_load_secrets_sync(matched, cancellable.get(), &loadError)) {
+                bool timedOut = g_cancellable_is_cancelled(cancellable.get()) != FALSE;
+                if (loadError) {
+                    g_error_free(loadError);
+                }
+                for (const auto& match : matches) {
+                    for (size_t index : services[match.first]) {
+                        results[index].failed = true;
+                        results[index].timedOut = timedOut;
+                    }
+                    services.erase(match.first);
+                }
+                matches.clear();
+            }
+            g_list_free(matched);
+
+            for (const auto& match : matches) {
+                SecretValue* value = secret_item_get_secret(match.second);
+                if (!value) {
+                    continue;
+                }
+                auto wantedService = services.find(match.first);
+                gsize length = 0;
+                const gchar* data = secret_value_get(value, &length);
+                for (size_t index : wantedService->second) {
+                    results[index].value = std::string(data, length);
+                }
+                secret_value_unref(value);
+
+                setResolvedSchema(wantedService->first, account.first, schema);
+                services.erase(wantedService);
+            }
+            g_list_free_full(found, g_object_unref);
+        }
+    }
+
+    if (deadline != 0) {
+        DeadlineTimer::shared().cancel(deadline);
+    }
+    return results;
+}
+
+static void forgetResolvedSchema(const std::string& service, const std::string& account) {
+    std::lock_guard<std::mutex> lock(resolvedSchemaMutex);
+    resolvedSchemas.erase(resolvedSchemaKey(service, account));
+}
+
+// Items earlier versions stored under the network schema carry only server
+// and user. Other applications' network passwords also set protocol, port,
+// domain or the like, so they are never taken for this module's.
+static bool hasLegacyAttributes(GHashTable* attributes) {
+    GHashTableIter iter;
+    gpointer name = nullptr;
+    g_hash_table_iter_init(&iter, attributes);
+    while (g_hash_table_iter_next(&iter, &name, nullptr)) {
+        std::string attribute = static_cast<const char*>(name);
+        if (attribute != "server" && attribute != "user" && attribute != "xdg:schema") {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One search per schema for the account's items (without secrets), then a
+// delete call for each match. Network-schema items must also look like the
+// ones earlier versions of this module stored.
+bool Keyring::removeMatchingLinux(const std::string& account, const std::string& servicePrefix,
+                                  const ServiceFilter& filter, std::vector<std::string>& removed) {
+    CancellablePtr cancellable = newCancellable();
+    uint64_t deadline = armCancellable(cancellable);
+    bool success = true;
+
+    for (ResolvedSchema schema : { ResolvedSchema::Generic, ResolvedSchema::Network }) {
+        const SecretSchema* secretSchema = schema == ResolvedSchema::Generic ? get_keyring_schema() : SECRET_SCHEMA_COMPAT_NETWORK;
+        GHashTable* attributes = schema == ResolvedSchema::Generic
+            ? secret_attributes_build(secretSchema, "username", account.c_str(), nullptr)
+            : secret_attributes_build(secretSchema, "user", account.c_str(), nullptr);
+
+        GError* error = nullptr;
+        GList* items = nullptr;
+        withSecretService([&](SecretService* proxy, GError** opError) {
+            items = secret_service_search_sync(
+                proxy,
+                secretSchema,
+                attributes,
+                static_cast<SecretSearchFlags>(SECRET_SEARCH_ALL | SECRET_SEARCH_UNLOCK),
+                cancellable.get(),
+                opError
+            );
+            return items != nullptr;
+        }, cancellable.get(), &error);
+        g_hash_table_unref(attributes);
+
+        if (error) {
+            g_error_free(error);
+            success = false;
+            break;
+        }
+
+        for (GList* node = items; node != nullptr; node = node->next) {
+            SecretItem* item = static_cast<SecretItem*>(node->data);
+            GHashTable* itemAttributes = secret_item_get_attributes(item);
+            const char* name = static_cast<const char*>(
+                g_hash_table_lookup(itemAttributes, schema == ResolvedSchema::Generic ? "service" : "server"));
+            std::string service = name ? name : "";
+            bool own = schema == ResolvedSchema::Generic || hasLegacyAttributes(itemAttributes);
+            g_hash_table_unref(itemAttributes);
+
+            if (!name || !own || service.compare(0, servicePrefix.size(), servicePrefix) != 0 || !filter(service)) {
+                continue;
+            }
+
+            GError* deleteError = nullptr;
+            if (secret_item_delete_sync(item, cancellable.get(), &deleteError)) {
+                forgetResolvedSchema(service, account);
+                removed.push_back(std::move(service));
+            } else {
+                success = false;
+            }
+            if (deleteError) {
+                g_error_free(deleteError);
+            }
+        }
+        g_list_free_full(items, g_object_unref);
+    }
+
+    if (deadline != 0) {
+        DeadlineTimer::shared().cancel(deadline);
+    }
+    return success;
+}
+
+static bool isOwnLegacyService(const std::string& service) {
+    for (const char* suffix : { "PublicKey", "PrivateKey", "KeyPair" }) {
+        size_t length = std::char_traits<char>::length(suffix);
+        if (service.size() > length && service.compare(service.size() - length, length, suffix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int Keyring::migrateLegacyItemsLinux() {
+    GError* error = nullptr;
+    GHashTable* attributes = secret_attributes_build(SECRET_SCHEMA_COMPAT_NETWORK, "user", "key", nullptr);
+
+    // One search for the legacy items, then one call loading the secrets of
+    // this module's items among them
+    GList* items = nullptr;
+    withSecretService([&](SecretService* proxy, GError** opError) {
+        items = secret_service_search_sync(
+            proxy,
             SECRET_SCHEMA_COMPAT_NETWORK,
+            attributes,
+            static_cast<SecretSearchFlags>(SECRET_SEARCH_ALL | SECRET_SEARCH_UNLOCK),
             nullptr,
-            &error,
-            "server", service.c_str(),
-            "user", account.c_str(),
-            nullptr
+            opError
         );
+        return items != nullptr;
+    }, nullptr, &error);
+    g_hash_table_unref(attributes);
+
+    if (error) {
+        g_error_free(error);
+        return 0;
+    }
 
+    struct LegacyItem {
+        SecretItem* item;
+        std::string service;
+        std::string account;
+    };
+    std::vector<LegacyItem> own;
+    GList* ownItems = nullptr;
+    for (GList* node = items; node != nullptr; node = node->next) {
+        SecretItem* item = static_cast<SecretItem*>(node->data);
+        GHashTable* itemAttributes = secret_item_get_attributes(item);
+        const char* server = static_cast<const char*>(g_hash_table_lookup(itemAttributes, "server"));
+        const char* user = static_cast<const char*>(g_hash_table_lookup(itemAttributes, "user"));
+        std::string service = server ? server : "";
+        std::string account = user ? user : "";
+        bool isOwn = isOwnLegacyService(service) && hasLegacyAttributes(itemAttributes);
+        g_hash_table_unref(itemAttributes);
+
+        if (isOwn) {
+            own.push_back({ item, std::move(service), std::move(account) });
+            ownItems = g_list_prepend(ownItems, item);
+        }
+    }
+
+    bool loaded = ownItems == nullptr || secret_item_load_secrets_sync(ownItems, nullptr, &error);
+    g_list_free(ownItems);
+    if (!loaded) {
         if (error) {
             g_error_free(error);
-            return std::nullopt;
         }
+        g_list_free_full(items, g_object_unref);
+        return 0;
     }
 
-    if (password) {
-        std::string result(password);
-        secret_password_free(password);
-        return result;
+    int migrated = 0;
+    for (const LegacyItem& legacy : own) {
+        SecretItem* item = legacy.item;
+        const std::string& service = legacy.service;
+        const std::string& account = legacy.account;
+        SecretValue* value = secret_item_get_secret(item);
+        if (!value) {
+            continue;
+        }
+
+        gsize length = 0;
+        const gchar* data = secret_value_get(value, &length);
+        std::string password(data, length);
+        secret_value_unref(value);
+
+        // Only remove the legacy item once the Generic copy is stored
+        if (setPasswordLinux(service, account, password)) {
+            GError* deleteError = nullptr;
+            secret_item_delete_sync(item, nullptr, &deleteError);
+            if (deleteError) {
+                g_error_free(deleteError);
+            }
+            cache().invalidate(service, account);
+            migrated++;
+        }
     }
 
-    return std::nullopt;
+    g_list_free_full(items, g_object_unref);
+    return migrated;
 }
 
 bool Keyring::setPasswordLinux(const std::string& service, const std::string& account, const std::string& password) {
@@ -157,28 +1320,58 @@ bool Keyring::setPasswordLinux(const std::string& service, const std::string& ac
     std::string label = "Password for '" + account + "' on '" + service + "'";
 
     // Use Python-compatible schema (Generic)
-    bool success = secret_password_store_sync(
+    GHashTable* attributes = secret_attributes_build(
         get_keyring_schema(),
-        SECRET_COLLECTION_DEFAULT,
-        label.c_str(),
-        password.c_str(),
-        nullptr,
-        &error,
         "service", service.c_str(),
         "username", account.c_str(),
         nullptr
     );
+    SecretValue* value = secret_value_new(password.c_str(), static_cast<gssize>(password.size()), "text/plain");
+
+    CancellablePtr cancellable = newCancellable();
+    uint64_t deadline = armCancellable(cancellable);
+    bool success = withSecretService([&](SecretService* proxy, GError** opError) {
+        return secret_service_store_sync(
+            proxy,
+            get_keyring_schema(),
+            attributes,
+            SECRET_COLLECTION_DEFAULT,
+            label.c_str(),
+            value,
+            cancellable.get(),
+            opError
+        ) != FALSE;
+    }, cancellable.get(), &error);
+
+    if (deadline != 0) {
+        DeadlineTimer::shared().cancel(deadline);
+    }
+    secret_value_unref(value);
+    g_hash_table_unref(attributes);
 
     if (error) {
         g_error_free(error);
         return false;
     }
 
+    if (success) {
+        setResolvedSchema(service, account, ResolvedSchema::Generic);
+    }
     return success;
 }
 #else
-std::optional<std::string> Keyring::getPasswordLinux(const std::string& service, const std::string& account) {
-    return std::nullopt;
+void Keyring::getPasswordLinuxAsync(const std::string& service, const std::string& account,
+                                    KeyringExecutor::ReadCallback done) {
+    done(KeyringReadResult{});
+}
+
+std::vector<KeyringReadResult> Keyring::getPasswordsLinux(const std::vector<KeyringItem>& items) {
+    return std::vector<KeyringReadResult>(items.size());
+}
+
+bool Keyring::removeMatchingLinux(const std::string& account, const std::string& servicePrefix,
+                                  const ServiceFilter& filter, std::vector<std::string>& removed) {
+    return false;
 }
 
 bool Keyring::setPasswordLinux(const std::string& service, const std::string& account, const std::string& password) {
@@ -254,6 +1447,68 @@ bool Keyring::setPasswordMacOS(const std::string& service, const std::string& ac
 
     return addStatus == errSecSuccess;
 }
+
+static std::string cfStringToStd(CFStringRef string) {
+    CFIndex size = CFStringGetMaximumSizeForEncoding(CFStringGetLength(string), kCFStringEncodingUTF8) + 1;
+    std::string result(static_cast<size_t>(size), '\0');
+    if (!CFStringGetCString(string, &result[0], size, kCFStringEncodingUTF8)) {
+        return std::string();
+    }
+    result.resize(std::char_traits<char>::length(result.c_str()));
+    return result;
+}
+
+// One query for every generic password of the account, then a delete per match
+bool Keyring::removeMatchingMacOS(const std::string& account, const std::string& servicePrefix,
+                                  const ServiceFilter& filter, std::vector<std::string>& removed) {
+    CFStringRef accountRef = CFStringCreateWithCString(nullptr, account.c_str(), kCFStringEncodingUTF8);
+    if (!accountRef) {
+        return false;
+    }
+
+    const void* queryKeys[] = { kSecClass, kSecAttrAccount, kSecMatchLimit, kSecReturnAttributes };
+    const void* queryValues[] = { kSecClassGenericPassword, accountRef, kSecMatchLimitAll, kCFBooleanTrue };
+    CFDictionaryRef query = CFDictionaryCreate(nullptr, queryKeys, queryValues, 4,
+                                               &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+    CFTypeRef found = nullptr;
+    OSStatus status = SecItemCopyMatching(query, &found);
+    CFRelease(query);
+
+    if (status != errSecSuccess) {
+        CFRelease(accountRef);
+        return status == errSecItemNotFound;
+    }
+
+    bool success = true;
+    CFArrayRef items = static_cast<CFArrayRef>(found);
+    for (CFIndex i = 0; i < CFArrayGetCount(items); i++) {
+        CFDictionaryRef attributes = static_cast<CFDictionaryRef>(CFArrayGetValueAtIndex(items, i));
+        CFStringRef serviceRef = static_cast<CFStringRef>(CFDictionaryGetValue(attributes, kSecAttrService));
+        if (!serviceRef) {
+            continue;
+        }
+
+        std::string service = cfStringToStd(serviceRef);
+        if (service.compare(0, servicePrefix.size(), servicePrefix) != 0 || !filter(service)) {
+            continue;
+        }
+
+        const void* deleteKeys[] = { kSecClass, kSecAttrService, kSecAttrAccount };
+        const void* deleteValues[] = { kSecClassGenericPassword, serviceRef, accountRef };
+        CFDictionaryRef deleteQuery = CFDictionaryCreate(nullptr, deleteKeys, deleteValues, 3,
+                                                         &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+        if (SecItemDelete(deleteQuery) == errSecSuccess) {
+            removed.push_back(std::move(service));
+        } else {
+            success = false;
+        }
+        CFRelease(deleteQuery);
+    }
+
+    CFRelease(found);
+    CFRelease(accountRef);
+    return success;
+}
 #endif
 
 } // namespace KeysGen
\ No newline at end of file
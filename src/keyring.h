@@ -1,27 +1,113 @@
 #pragma once
 
+#include "keyring_cache.h"
+#include "keyring_backend.h"
+#include "keyring_executor.h"
+#include <functional>
+#include <memory>
 #include <string>
 #include <optional>
+#include <vector>
 
 namespace KeysGen {
 
 class Keyring {
 public:
+    using PasswordCallback = std::function<void(std::optional<std::string>)>;
+
+    // Blocks until the keyring thread answers. On the keyring thread itself
+    // it asks the backend directly instead of queueing behind the caller.
     static std::optional<std::string> getPassword(const std::string& service, const std::string& account);
+    // Non-blocking lookup; done runs on the calling thread for cache hits,
+    // otherwise on the keyring thread, and must not block. Cancelling settles
+    // the lookup as failed (on the cancelling thread) and drops the backend
+    // call once no other caller waits for it.
+    static void getPasswordAsync(const std::string& service, const std::string& account, PasswordCallback done,
+                                 const CancellationPtr& cancellation = nullptr);
     static bool setPassword(const std::string& service, const std::string& account, const std::string& password);
+    // Non-blocking write; done runs on the keyring thread (or the caller for
+    // backends that do not use it) with the result
+    static void setPasswordAsync(const std::string& service, const std::string& account, const std::string& password,
+                                 std::function<void(bool)> done);
+    // Looks up many items with one backend pass for those not cached (a single
+    // search on Linux); results are in the order of items. Blocks like getPassword.
+    static std::vector<std::optional<std::string>> getPasswords(const std::vector<KeyringItem>& items);
+    // Like getPassword, getPasswordAsync and getPasswords, but a failed or
+    // timed-out read (or one refused by the open breaker) is reported as
+    // failed rather than as a miss. Callers that write on a miss must use these.
+    static KeyringReadResult lookup(const std::string& service, const std::string& account);
+    static void lookupAsync(const std::string& service, const std::string& account, KeyringExecutor::ReadCallback done,
+                            const CancellationPtr& cancellation = nullptr);
+    static std::vector<KeyringReadResult> lookupMany(const std::vector<KeyringItem>& items);
     static bool isAvailable();
+    // Deletes every item of `account` whose service starts with servicePrefix
+    // and passes filter, in one backend pass. Returns the number deleted, or
+    // -1 if the backend could not be searched or an item could not be deleted.
+    static int deletePasswords(const std::string& account, const std::string& servicePrefix, const ServiceFilter& filter);
+
+    // Reads or writes an item in a specific backend, bypassing the cache and
+    // the active selection (used for the file keystore's master key)
+    static std::optional<std::string> getPasswordFrom(const std::string& backendName,
+                                                      const std::string& service, const std::string& account);
+    static bool setPasswordIn(const std::string& backendName, const std::string& service,
+                              const std::string& account, const std::string& password);
+
+    // Selects a registered backend by name ("system", "kernel", "memory", "file");
+    // false if there is none. Switching backends clears the in-process cache.
+    static bool setBackend(const std::string& name);
+    static std::string getBackendName();
+    // Adds (or replaces) a backend selectable by its name()
+    static void registerBackend(std::shared_ptr<KeyringBackend> backend);
+
+    // In-process cache in front of getPassword; ttlMs = 0 disables it
+    static void configureCache(size_t maxEntries, long long ttlMs);
+    // Remember confirmed misses for ttlMs so repeated misses skip the backend
+    static void configureNegativeCache(long long ttlMs);
+    static void invalidateCache(const std::string& service, const std::string& account);
+    static void clearCache();
+    static KeyringCacheStats getCacheStats();
+
+    // Rewrites items stored under the legacy network schema into the Generic
+    // schema (Linux); returns the number of migrated items
+    static int migrateLegacyItems();
+
+    // Per-call deadline (0 = none) and the circuit breaker that fails calls
+    // fast after breakerThreshold consecutive timeouts (0 = never) for
+    // breakerCooldownMs. Negative values keep the current setting.
+    static void configureTimeouts(int timeoutMs, int breakerThreshold, int breakerCooldownMs);
+    static bool isCircuitOpen();
+
+    // Batching window of the keyring thread, see KeyringExecutor
+    static void setBatchWindow(int windowMs);
+    // Stops the keyring thread (it restarts on the next call)
+    static void shutdown();
 
 private:
+    friend class SystemKeyring;
+
+    static KeyringCache& cache();
+    // generation: cache().generation() taken before the backend was asked
+    static void rememberLookup(const std::string& service, const std::string& account,
+                               const KeyringReadResult& result, uint64_t generation);
+
 #ifdef _WIN32
     static bool setPasswordWindows(const std::string& service, const std::string& account, const std::string& password);
+    static bool removeMatchingWindows(const std::string& account, const std::string& servicePrefix,
+                                      const ServiceFilter& filter, std::vector<std::string>& removed);
     static std::optional<std::string> getPasswordWindows(const std::string& service, const std::string& account);
 #endif
 #ifdef __linux__
     static bool setPasswordLinux(const std::string& service, const std::string& account, const std::string& password);
-    static std::optional<std::string> getPasswordLinux(const std::string& service, const std::string& account);
+    static void getPasswordLinuxAsync(const std::string& service, const std::string& account, KeyringExecutor::ReadCallback done);
+    static std::vector<KeyringReadResult> getPasswordsLinux(const std::vector<KeyringItem>& items);
+    static bool removeMatchingLinux(const std::string& account, const std::string& servicePrefix,
+                                    const ServiceFilter& filter, std::vector<std::string>& removed);
+    static int migrateLegacyItemsLinux();
 #endif
 #ifdef __APPLE__
     static bool setPasswordMacOS(const std::string& service, const std::string& account, const std::string& password);
+    static bool removeMatchingMacOS(const std::string& account, const std::string& servicePrefix,
+                                    const ServiceFilter& filter, std::vector<std::string>& removed);
     static std::optional<std::string> getPasswordMacOS(const std::string& service, const std::string& account);
 #endif
 };
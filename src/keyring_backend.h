@@ -0,0 +1,62 @@
+#pragma once
+
+#include "keyring_executor.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace KeysGen {
+
+struct KeyringItem {
+    std::string service;
+    std::string account;
+};
+
+using ServiceFilter = std::function<bool(const std::string& service)>;
+
+// A store behind the Keyring API. Keyring keeps the in-process cache,
+// timeouts and the circuit breaker in front of whichever backend is active.
+class KeyringBackend {
+public:
+    virtual ~KeyringBackend() = default;
+
+    // Name used to select the backend from configuration and JS
+    virtual const char* name() const = 0;
+    virtual bool isAvailable() = 0;
+
+    // Blocking stores (D-Bus, OS credential APIs) run on the keyring thread,
+    // serialized and bounded by the keyring timeout. Others are called
+    // directly on the caller's thread and must be thread-safe.
+    virtual bool usesKeyringThread() const = 0;
+
+    // Must call done exactly once, possibly later from the keyring thread
+    virtual void get(const std::string& service, const std::string& account,
+                     KeyringExecutor::ReadCallback done) = 0;
+    virtual bool set(const std::string& service, const std::string& account, const std::string& password) = 0;
+
+    // Deletes every item of `account` whose service starts with servicePrefix
+    // and passes filter, in one search-and-delete pass. Deleted services are
+    // appended to removed; false if the store could not be searched or an
+    // item could not be deleted.
+    virtual bool removeMatching(const std::string& account, const std::string& servicePrefix,
+                                const ServiceFilter& filter, std::vector<std::string>& removed) = 0;
+
+    // Reads several items in one pass, one result per item in order. Runs on
+    // the keyring thread for backends that use it. The default issues one
+    // get() per item and needs get() to call done before returning; backends
+    // that complete asynchronously override it.
+    virtual std::vector<KeyringReadResult> getMany(const std::vector<KeyringItem>& items) {
+        std::vector<KeyringReadResult> results(items.size());
+        for (size_t i = 0; i < items.size(); i++) {
+            KeyringReadResult* slot = &results[i];
+            slot->failed = true;
+            get(items[i].service, items[i].account, [slot](KeyringReadResult result) {
+                *slot = std::move(result);
+            });
+        }
+        return results;
+    }
+};
+
+} // namespace KeysGen
\ No newline at end of file
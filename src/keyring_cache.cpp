@@ -0,0 +1,214 @@
+#include "keyring_cache.h"
+#include <functional>
+#include <iterator>
+
+namespace KeysGen {
+
+std::string KeyringCache::makeKey(const std::string& service, const std::string& account) {
+    std::string key;
+    key.reserve(service.size() + account.size() + 1);
+    key.append(service).push_back('\0');
+    key.append(account);
+    return key;
+}
+
+size_t KeyringCache::stripeOf(const std::string& key) {
+    return std::hash<std::string>()(key) % kGenerationStripes;
+}
+
+uint64_t KeyringCache::generation(const std::string& service, const std::string& account) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generations_[stripeOf(makeKey(service, account))];
+}
+
+void KeyringCache::configure(size_t maxEntries, long long ttlMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxEntries_ = maxEntries;
+    ttlMs_ = ttlMs > 0 ? ttlMs : 0;
+
+    if (maxEntries_ == 0 || ttlMs_ == 0) {
+        lru_.clear();
+        index_.clear();
+        return;
+    }
+    evictOverflow();
+}
+
+void KeyringCache::configureNegative(long long negativeTtlMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    negativeTtlMs_ = negativeTtlMs > 0 ? negativeTtlMs : 0;
+    if (negativeTtlMs_ == 0) {
+        missing_.clear();
+    }
+}
+
+bool KeyringCache::negativeEnabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return negativeTtlMs_ > 0;
+}
+
+bool KeyringCache::enabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maxEntries_ > 0 && ttlMs_ > 0;
+}
+
+std::optional<std::string> KeyringCache::get(const std::string& service, const std::string& account) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(makeKey(service, account));
+    if (it == index_.end()) {
+        misses_++;
+        return std::nullopt;
+    }
+
+    if (Clock::now() >= it->second->expires) {
+        lru_.erase(it->second);
+        index_.erase(it);
+        misses_++;
+        return std::nullopt;
+    }
+
+    // Move to the front to mark as most recently used
+    lru_.splice(lru_.begin(), lru_, it->second);
+    hits_++;
+    return it->second->value;
+}
+
+void KeyringCache::put(const std::string& service, const std::string& account, const std::string& value,
+                       uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (maxEntries_ == 0 || ttlMs_ == 0) {
+        return;
+    }
+
+    std::string key = makeKey(service, account);
+    if (generations_[stripeOf(key)] != generation) {
+        // Written or invalidated while the read was in flight
+        return;
+    }
+    insertLocked(std::move(key), value);
+}
+
+void KeyringCache::store(const std::string& service, const std::string& account, const std::string& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::string key = makeKey(service, account);
+    // Reads that started before this write must not replace its value
+    generations_[stripeOf(key)]++;
+    if (maxEntries_ == 0 || ttlMs_ == 0) {
+        missing_.erase(key);
+        return;
+    }
+    insertLocked(std::move(key), value);
+}
+
+// Must be called with the mutex held
+void KeyringCache::insertLocked(std::string key, const std::string& value) {
+    Clock::time_point expires = Clock::now() + std::chrono::milliseconds(ttlMs_);
+    missing_.erase(key);
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->value = value;
+        it->second->expires = expires;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+
+    lru_.push_front(Entry{ key, value, expires });
+    index_.emplace(std::move(key), lru_.begin());
+    evictOverflow();
+}
+
+bool KeyringCache::isKnownMissing(const std::string& service, const std::string& account) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = missing_.find(makeKey(service, account));
+    if (it == missing_.end()) {
+        return false;
+    }
+
+    if (Clock::now() >= it->second) {
+        missing_.erase(it);
+        return false;
+    }
+
+    negativeHits_++;
+    return true;
+}
+
+void KeyringCache::putMissing(const std::string& service, const std::string& account, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (negativeTtlMs_ == 0) {
+        return;
+    }
+
+    std::string key = makeKey(service, account);
+    if (generations_[stripeOf(key)] != generation) {
+        return;
+    }
+
+    // Bounded like the positive entries: purge expired misses, then all
+    Clock::time_point now = Clock::now();
+    if (missing_.size() >= (maxEntries_ > 0 ? maxEntries_ : 1024)) {
+        for (auto it = missing_.begin(); it != missing_.end();) {
+            it = now >= it->second ? missing_.erase(it) : std::next(it);
+        }
+        if (missing_.size() >= (maxEntries_ > 0 ? maxEntries_ : 1024)) {
+            missing_.clear();
+        }
+    }
+
+    missing_[std::move(key)] = now + std::chrono::milliseconds(negativeTtlMs_);
+}
+
+void KeyringCache::invalidate(const std::string& service, const std::string& account) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::string key = makeKey(service, account);
+    generations_[stripeOf(key)]++;
+    missing_.erase(key);
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+}
+
+void KeyringCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint64_t& generation : generations_) {
+        generation++;
+    }
+    lru_.clear();
+    index_.clear();
+    missing_.clear();
+}
+
+KeyringCacheStats KeyringCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    KeyringCacheStats result;
+    result.entries = lru_.size();
+    result.maxEntries = maxEntries_;
+    result.ttlMs = ttlMs_;
+    result.hits = hits_;
+    result.misses = misses_;
+    result.evictions = evictions_;
+    result.missingEntries = missing_.size();
+    result.negativeTtlMs = negativeTtlMs_;
+    result.negativeHits = negativeHits_;
+    return result;
+}
+
+// Must be called with the mutex held
+void KeyringCache::evictOverflow() {
+    while (lru_.size() > maxEntries_) {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+        evictions_++;
+    }
+}
+
+} // namespace KeysGen
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace KeysGen {
+
+struct KeyringCacheStats {
+    size_t entries = 0;
+    size_t maxEntries = 0;
+    long long ttlMs = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t missingEntries = 0;
+    long long negativeTtlMs = 0;
+    size_t negativeHits = 0;
+};
+
+// Bounded, thread-safe LRU cache of keyring values with a per-entry TTL.
+// Disabled while ttlMs or maxEntries is 0. Confirmed misses are remembered
+// separately for negativeTtlMs (0 disables negative caching).
+//
+// Every key has a generation that writes and invalidations bump. A read takes
+// generation() before asking the backend and passes it to put/putMissing,
+// which drop the result if a write happened meanwhile, so a slow read cannot
+// cache the value a newer write replaced.
+class KeyringCache {
+public:
+    void configure(size_t maxEntries, long long ttlMs);
+    void configureNegative(long long negativeTtlMs);
+    bool enabled() const;
+    bool negativeEnabled() const;
+
+    std::optional<std::string> get(const std::string& service, const std::string& account);
+    uint64_t generation(const std::string& service, const std::string& account) const;
+    // Caches a read result taken at `generation`
+    void put(const std::string& service, const std::string& account, const std::string& value, uint64_t generation);
+    // Caches a value just written; newer than any read in flight
+    void store(const std::string& service, const std::string& account, const std::string& value);
+    bool isKnownMissing(const std::string& service, const std::string& account);
+    void putMissing(const std::string& service, const std::string& account, uint64_t generation);
+    void invalidate(const std::string& service, const std::string& account);
+    void clear();
+
+    KeyringCacheStats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string key;
+        std::string value;
+        Clock::time_point expires;
+    };
+
+    // Generations are kept per hash stripe so they stay bounded; keys that
+    // share a stripe only cost each other a skipped cache fill
+    static constexpr size_t kGenerationStripes = 256;
+
+    static std::string makeKey(const std::string& service, const std::string& account);
+    static size_t stripeOf(const std::string& key);
+    void insertLocked(std::string key, const std::string& value);
+    void evictOverflow();
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::unordered_map<std::string, Clock::time_point> missing_;  // key -> expiry
+    uint64_t generations_[kGenerationStripes] = {};
+    size_t maxEntries_ = 1024;
+    long long ttlMs_ = 0;
+    long long negativeTtlMs_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t evictions_ = 0;
+    size_t negativeHits_ = 0;
+};
+
+} // namespace KeysGen
\ No newline at end of file
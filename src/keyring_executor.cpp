@@ -0,0 +1,362 @@
+#include "keyring_executor.h"
+#include <utility>
+
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+#include <glib.h>
+#endif
+
+namespace KeysGen {
+
+KeyringExecutor& KeyringExecutor::instance() {
+    static KeyringExecutor executor;
+    return executor;
+}
+
+KeyringExecutor::~KeyringExecutor() {
+    shutdown();
+}
+
+void KeyringExecutor::readAsync(const std::string& key, AsyncReadOp op, ReadCallback done,
+                                const CancellationPtr& cancellation) {
+    std::shared_ptr<ReadSlot> slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pendingReads_.find(key);
+        if (it != pendingReads_.end()) {
+            // Coalesce with the identical read that is queued or in flight
+            slot = it->second;
+            slot->waiters.push_back(std::move(done));
+        } else {
+            slot = std::make_shared<ReadSlot>();
+            slot->waiters.push_back(std::move(done));
+            pendingReads_.emplace(key, slot);
+            readsInFlight_++;
+
+            tasks_.push_back([this, key, slot, op = std::move(op)]() {
+                bool skipped = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (slot->cancelled == slot->waiters.size()) {
+                        // Every waiter gave up before the read started
+                        skipped = true;
+                    }
+                }
+                KeyringReadResult failure;
+                failure.failed = true;
+                if (skipped) {
+                    finishRead(key, slot, std::move(failure));
+                    return;
+                }
+
+                std::shared_ptr<ReadSlot> outer = std::move(runningRead_);
+                runningRead_ = slot;
+                try {
+                    op([this, key, slot](KeyringReadResult result) {
+                        finishRead(key, slot, std::move(result));
+                    });
+                } catch (...) {
+                    finishRead(key, slot, std::move(failure));
+                }
+                runningRead_ = std::move(outer);
+            });
+            ensureStarted();
+            wake();
+        }
+    }
+
+    if (cancellation) {
+        // May run right here when the caller is already cancelled
+        cancellation->onCancel([this, key, slot]() { cancelWaiter(key, slot); });
+    }
+}
+
+void KeyringExecutor::cancelWaiter(const std::string& key, const std::shared_ptr<ReadSlot>& slot) {
+    std::function<void()> abandon;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slot->finished || ++slot->cancelled < slot->waiters.size()) {
+            return;
+        }
+
+        // Reads arriving from now on must not join a read nobody waits for
+        auto pending = pendingReads_.find(key);
+        if (pending != pendingReads_.end() && pending->second == slot) {
+            pendingReads_.erase(pending);
+        }
+        abandon = std::move(slot->abandon);
+        slot->abandon = nullptr;
+    }
+
+    if (abandon) {
+        abandon();
+    }
+}
+
+void KeyringExecutor::onAbandon(std::function<void()> abandon) {
+    std::shared_ptr<ReadSlot> slot = runningRead_;
+    if (!slot) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slot->finished) {
+            return;
+        }
+        if (slot->cancelled < slot->waiters.size()) {
+            slot->abandon = std::move(abandon);
+            return;
+        }
+    }
+    abandon();
+}
+
+void KeyringExecutor::finishRead(const std::string& key, const std::shared_ptr<ReadSlot>& slot,
+                                 KeyringReadResult result) {
+    std::vector<ReadCallback> waiters;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slot->finished) {
+            return;
+        }
+        slot->finished = true;
+        slot->abandon = nullptr;
+        readsInFlight_--;
+
+        // Reads arriving from now on need a fresh backend call
+        auto pending = pendingReads_.find(key);
+        if (pending != pendingReads_.end() && pending->second == slot) {
+            pendingReads_.erase(pending);
+        }
+        waiters.swap(slot->waiters);
+    }
+
+    for (auto& waiter : waiters) {
+        try {
+            waiter(result);
+        } catch (...) {
+            // One failing waiter must not starve the others
+        }
+    }
+}
+
+bool KeyringExecutor::write(const std::string& key, std::function<bool()> op) {
+    if (onExecutorThread()) {
+        return op();
+    }
+
+    std::promise<bool> promise;
+    std::future<bool> future = promise.get_future();
+    writeAsync(key, std::move(op), [&promise](bool success) { promise.set_value(success); });
+    return future.get();
+}
+
+void KeyringExecutor::writeAsync(const std::string& key, std::function<bool()> op, std::function<void(bool)> done) {
+    if (onExecutorThread()) {
+        bool success = false;
+        try {
+            success = op();
+        } catch (...) {
+            success = false;
+        }
+        done(success);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Later reads must observe this write, not join an earlier read
+    pendingReads_.erase(key);
+    tasks_.push_back([op = std::move(op), done = std::move(done)]() {
+        bool success = false;
+        try {
+            success = op();
+        } catch (...) {
+            success = false;
+        }
+        done(success);
+    });
+    ensureStarted();
+    wake();
+}
+
+void KeyringExecutor::run(std::function<void()> task) {
+    if (onExecutorThread()) {
+        task();
+        return;
+    }
+
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+    enqueue([promise, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            // Tasks report failures through their own results
+        }
+        promise->set_value();
+    });
+
+    future.get();
+}
+
+void KeyringExecutor::post(std::function<void()> task) {
+    enqueue([task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            // Tasks report failures through their own results
+        }
+    });
+}
+
+void KeyringExecutor::setBatchWindow(std::chrono::milliseconds window) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batchWindow_ = window.count() > 0 ? window : std::chrono::milliseconds(0);
+}
+
+void KeyringExecutor::shutdown() {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!worker_.joinable() || onExecutorThread()) {
+            return;
+        }
+        stopping_ = true;
+        worker.swap(worker_);
+        wake();
+    }
+    worker.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    workerId_.store(std::thread::id());
+    stopping_ = false;
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    if (context_) {
+        g_main_context_unref(static_cast<GMainContext*>(context_));
+        context_ = nullptr;
+    }
+#endif
+}
+
+void KeyringExecutor::enqueue(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    ensureStarted();
+    wake();
+}
+
+// Must be called with the mutex held
+void KeyringExecutor::ensureStarted() {
+    if (!worker_.joinable()) {
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+        if (!context_) {
+            context_ = g_main_context_new();
+        }
+#endif
+        worker_ = std::thread(&KeyringExecutor::workerLoop, this);
+        workerId_.store(worker_.get_id());
+    }
+}
+
+// Must be called with the mutex held, so the context cannot go away
+void KeyringExecutor::wake() {
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    if (context_) {
+        g_main_context_wakeup(static_cast<GMainContext*>(context_));
+    }
+#endif
+    taskAvailable_.notify_all();
+}
+
+// Blocks until a task is queued or, on Linux, a main context source fired
+void KeyringExecutor::waitForWork(std::unique_lock<std::mutex>& lock) {
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    GMainContext* context = static_cast<GMainContext*>(context_);
+    lock.unlock();
+    g_main_context_iteration(context, TRUE);
+    lock.lock();
+#else
+    taskAvailable_.wait(lock);
+#endif
+}
+
+// Sleeps on the executor thread; on Linux in-flight lookups keep completing
+void KeyringExecutor::waitFor(std::chrono::milliseconds duration) {
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    GMainContext* context = static_cast<GMainContext*>(context_);
+    bool elapsed = false;
+    GSource* timeout = g_timeout_source_new(static_cast<guint>(duration.count()));
+    g_source_set_callback(timeout, [](gpointer data) -> gboolean {
+        *static_cast<bool*>(data) = true;
+        return G_SOURCE_REMOVE;
+    }, &elapsed, nullptr);
+    g_source_attach(timeout, context);
+    while (!elapsed) {
+        g_main_context_iteration(context, TRUE);
+    }
+    g_source_unref(timeout);
+#else
+    std::this_thread::sleep_for(duration);
+#endif
+}
+
+bool KeyringExecutor::onExecutorThread() const {
+    return std::this_thread::get_id() == workerId_.load();
+}
+
+void KeyringExecutor::pumpUntil(const std::function<bool()>& finished) {
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    GMainContext* context = static_cast<GMainContext*>(context_);
+    while (!finished()) {
+        g_main_context_iteration(context, TRUE);
+    }
+#else
+    // Backends elsewhere answer before get() returns
+    (void)finished;
+#endif
+}
+
+void KeyringExecutor::workerLoop() {
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    // Everything libsecret/GDBus attaches to the thread-default context
+    // (proxy signals, pending calls) stays on this thread
+    GMainContext* context = static_cast<GMainContext*>(context_);
+    g_main_context_push_thread_default(context);
+#endif
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (tasks_.empty()) {
+            // Async reads still in flight complete through the main context
+            if (stopping_ && readsInFlight_ == 0) {
+                break;
+            }
+            waitForWork(lock);
+            continue;
+        }
+
+        // Give concurrent callers a moment to queue reads that coalesce
+        if (batchWindow_.count() > 0 && !stopping_) {
+            std::chrono::milliseconds window = batchWindow_;
+            lock.unlock();
+            waitFor(window);
+            lock.lock();
+        }
+
+        std::deque<std::function<void()>> batch;
+        batch.swap(tasks_);
+        lock.unlock();
+
+        for (auto& task : batch) {
+            task();
+        }
+
+        lock.lock();
+    }
+
+#if defined(__linux__) && defined(HAVE_LIBSECRET)
+    g_main_context_pop_thread_default(context);
+#endif
+}
+
+} // namespace KeysGen
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "cancellation.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace KeysGen {
+
+// Outcome of one backend read. Failures (errors, timeouts) are not misses
+// and must not be remembered as such.
+struct KeyringReadResult {
+    std::optional<std::string> value;
+    bool failed = false;
+    bool timedOut = false;
+};
+
+// Single native thread that owns all keyring backend calls. On Linux it runs
+// a GMainContext as the thread-default context, so libsecret's D-Bus proxy is
+// created and used from one thread and async lookups complete on it without
+// blocking. Identical reads are coalesced into a single backend call.
+class KeyringExecutor {
+public:
+    using ReadCallback = std::function<void(KeyringReadResult)>;
+    // Starts a read on the executor thread; it must call its argument exactly
+    // once, either before returning or later from the executor's main context
+    using AsyncReadOp = std::function<void(ReadCallback)>;
+
+    static KeyringExecutor& instance();
+
+    // Starts op on the executor thread and calls done there with the result.
+    // Reads of the same key that are queued or in flight share one op. Once
+    // every waiter's cancellation tripped, a queued op is skipped and a
+    // started one is abandoned (see onAbandon); done still runs.
+    void readAsync(const std::string& key, AsyncReadOp op, ReadCallback done,
+                   const CancellationPtr& cancellation = nullptr);
+    // Called by a running read op: abandon runs (on the cancelling thread) once
+    // no waiter wants the result any more, e.g. to cancel the backend call
+    void onAbandon(std::function<void()> abandon);
+
+    // Runs op on the executor thread after everything queued before it.
+    // Reads of `key` queued later do not join reads queued earlier.
+    bool write(const std::string& key, std::function<bool()> op);
+    // Non-blocking write; done runs on the executor thread with op's result
+    void writeAsync(const std::string& key, std::function<bool()> op, std::function<void(bool)> done);
+
+    // Runs an arbitrary task on the executor thread and waits for it
+    void run(std::function<void()> task);
+    // Queues a task on the executor thread without waiting for it
+    void post(std::function<void()> task);
+
+    // True on the executor thread, where waiting for queued work deadlocks
+    bool onExecutorThread() const;
+    // On the executor thread: dispatches the main context (Linux) until
+    // finished() holds, so a backend read started inline can complete there
+    void pumpUntil(const std::function<bool()>& finished);
+
+    // How long the executor waits after waking up so concurrent reads can
+    // pile up and be coalesced (0 = dispatch immediately)
+    void setBatchWindow(std::chrono::milliseconds window);
+
+    // Drains the queue and joins the thread; it restarts on the next call
+    void shutdown();
+
+    ~KeyringExecutor();
+
+private:
+    struct ReadSlot {
+        std::vector<ReadCallback> waiters;
+        size_t cancelled = 0;  // waiters that no longer want the result
+        bool finished = false;
+        std::function<void()> abandon;
+    };
+
+    KeyringExecutor() = default;
+    void enqueue(std::function<void()> task);
+    void ensureStarted();
+    void wake();
+    void waitForWork(std::unique_lock<std::mutex>& lock);
+    void waitFor(std::chrono::milliseconds duration);
+    void finishRead(const std::string& key, const std::shared_ptr<ReadSlot>& slot, KeyringReadResult result);
+    void cancelWaiter(const std::string& key, const std::shared_ptr<ReadSlot>& slot);
+    void workerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable taskAvailable_;
+    std::deque<std::function<void()>> tasks_;
+    std::unordered_map<std::string, std::shared_ptr<ReadSlot>> pendingReads_;
+    // Read whose op is running; only used on the executor thread
+    std::shared_ptr<ReadSlot> runningRead_;
+    std::thread worker_;
+    std::atomic<std::thread::id> workerId_{};
+    std::chrono::milliseconds batchWindow_{0};
+    size_t readsInFlight_ = 0;
+    bool stopping_ = false;
+    // GMainContext* on Linux with libsecret, unused elsewhere
+    void* context_ = nullptr;
+};
+
+} // namespace KeysGen
\ No newline at end of file
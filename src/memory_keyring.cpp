@@ -0,0 +1,50 @@
+#include "memory_keyring.h"
+
+namespace KeysGen {
+
+static std::string itemKey(const std::string& service, const std::string& account) {
+    return service + '\0' + account;
+}
+
+void MemoryKeyring::get(const std::string& service, const std::string& account,
+                        KeyringExecutor::ReadCallback done) {
+    KeyringReadResult result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = items_.find(itemKey(service, account));
+        if (it != items_.end()) {
+            result.value = it->second;
+        }
+    }
+    done(std::move(result));
+}
+
+bool MemoryKeyring::set(const std::string& service, const std::string& account, const std::string& password) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    items_[itemKey(service, account)] = password;
+    return true;
+}
+
+bool MemoryKeyring::removeMatching(const std::string& account, const std::string& servicePrefix,
+                                   const ServiceFilter& filter, std::vector<std::string>& removed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = items_.begin(); it != items_.end();) {
+        size_t separator = it->first.find('\0');
+        std::string service = it->first.substr(0, separator);
+        if (it->first.compare(separator + 1, std::string::npos, account) == 0 &&
+            service.compare(0, servicePrefix.size(), servicePrefix) == 0 && filter(service)) {
+            removed.push_back(std::move(service));
+            it = items_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return true;
+}
+
+void MemoryKeyring::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    items_.clear();
+}
+
+} // namespace KeysGen
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "keyring_backend.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace KeysGen {
+
+// Process-local store; nothing is persisted. For tests, benchmarks and
+// ephemeral workloads that should not touch the OS store.
+class MemoryKeyring : public KeyringBackend {
+public:
+    const char* name() const override { return "memory"; }
+    bool isAvailable() override { return true; }
+    bool usesKeyringThread() const override { return false; }
+
+    void get(const std::string& service, const std::string& account,
+             KeyringExecutor::ReadCallback done) override;
+    bool set(const std::string& service, const std::string& account, const std::string& password) override;
+    bool removeMatching(const std::string& account, const std::string& servicePrefix,
+                        const ServiceFilter& filter, std::vector<std::string>& removed) override;
+
+    void clear();
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::string> items_;
+};
+
+} // namespace KeysGen
\ No newline at end of file
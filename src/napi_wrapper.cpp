@@ -1,54 +1,403 @@
 #include <napi.h>
 #include "platform_utils.h"
 #include "keyring.h"
+#include "keyring_executor.h"
+#include "kernel_keyring.h"
+#include "file_keystore.h"
 #include "rsa_generator.h"
+#include "key_pool.h"
+#include "write_behind.h"
+#include "thread_pool.h"
+#include "cancellation.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 using namespace KeysGen;
 
-// Generate RSA keys and return the public key
-Napi::Value GenerateKeys(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
+// How keys are handed to JS
+enum class KeyOutput {
+    String,     // V8 string, copied and UTF-8 decoded
+    Buffer      // Buffer over the native allocation
+};
 
-    try {
-        // serviceName is required (first parameter)
-        if (info.Length() < 1 || !info[0].IsString()) {
-            Napi::TypeError::New(env, "serviceName (string) is required as first parameter")
-                .ThrowAsJavaScriptException();
+static std::atomic<KeyOutput> keyOutput(KeyOutput::String);
+static std::atomic<KeyFormat> keyFormat(KeyFormat::Pkcs1Pem);
+
+// Buffer over the bytes' own allocation, freed when JS drops it
+static Napi::Value OwnedBuffer(Napi::Env env, std::string&& bytes) {
+    auto* owned = new std::string(std::move(bytes));
+    // Copies (and frees owned at once) where external buffers are not allowed
+    return Napi::Buffer<char>::NewOrCopy(env, &(*owned)[0], owned->size(),
+        [](Napi::Env, char*, std::string* hint) { delete hint; }, owned);
+}
+
+// Keys are generated and stored as PKCS#1 PEM; re-encodes one for format
+static std::optional<std::string> ConvertKey(std::optional<std::string> key, bool isPrivate, KeyFormat format) {
+    if (!key.has_value() || format == KeyFormat::Pkcs1Pem) {
+        return key;
+    }
+    return RSAGenerator::convertKey(key.value(), isPrivate, KeyFormat::Pkcs1Pem, format);
+}
+
+// Converts a key encoded as format to the configured output, taking over its
+// allocation. The Buffer form keeps the bytes outside the V8 heap and frees
+// them when JS drops the value. DER is always a Buffer and raw keys an
+// object of component Buffers.
+static Napi::Value KeyToValue(Napi::Env env, std::string&& key, KeyFormat format) {
+    if (format == KeyFormat::Raw) {
+        static const char* const kComponentNames[] = { "n", "e", "d", "p", "q" };
+        auto components = RSAGenerator::splitRawKey(key);
+        if (components.empty()) {
             return env.Null();
         }
 
-        std::string serviceName = info[0].As<Napi::String>().Utf8Value();
+        Napi::Object result = Napi::Object::New(env);
+        for (size_t i = 0; i < components.size(); i++) {
+            result.Set(kComponentNames[i], OwnedBuffer(env, std::move(components[i])));
+        }
+        return result;
+    }
 
-        // keyLength is optional (second parameter)
-        int keyLength = 2048; // default
-        if (info.Length() > 1 && info[1].IsNumber()) {
-            keyLength = info[1].As<Napi::Number>().Int32Value();
+    if (format == KeyFormat::Pkcs1Der || format == KeyFormat::Pkcs8Der) {
+        return OwnedBuffer(env, std::move(key));
+    }
+
+    switch (keyOutput.load()) {
+    case KeyOutput::Buffer:
+        return OwnedBuffer(env, std::move(key));
+    default:
+        return Napi::String::New(env, key);
+    }
+}
+
+// Trips a Cancellation when the AbortSignal passed to an async call aborts.
+// Lives on the JS thread with the call; the listener is removed when the call
+// settles, so a long-lived signal does not pile up one listener per call.
+class AbortListener {
+public:
+    AbortListener() : cancellation_(std::make_shared<Cancellation>()) {}
+
+    // Accepts undefined/null or an AbortSignal; otherwise throws a TypeError
+    bool Attach(Napi::Env env, const Napi::Value& value) {
+        if (value.IsUndefined() || value.IsNull()) {
+            return true;
+        }
+        if (!value.IsObject() || !value.As<Napi::Object>().Get("addEventListener").IsFunction()) {
+            Napi::TypeError::New(env, "signal must be an AbortSignal").ThrowAsJavaScriptException();
+            return false;
+        }
+
+        Napi::Object signal = value.As<Napi::Object>();
+        signal_ = Napi::Persistent(signal);
+        if (signal.Get("aborted").ToBoolean()) {
+            cancellation_->cancel();
+            return true;
+        }
+
+        CancellationPtr cancellation = cancellation_;
+        Napi::Function listener = Napi::Function::New(env, [cancellation](const Napi::CallbackInfo& info) {
+            cancellation->cancel();
+            return info.Env().Undefined();
+        });
+        Napi::Object options = Napi::Object::New(env);
+        options.Set("once", true);
+        signal.Get("addEventListener").As<Napi::Function>().Call(signal, { Napi::String::New(env, "abort"), listener, options });
+        listener_ = Napi::Persistent(listener);
+        return !env.IsExceptionPending();
+    }
+
+    const CancellationPtr& cancellation() const { return cancellation_; }
+
+    // Removes the listener. If the call was cancelled (and so changed
+    // nothing), rejects deferred with the signal's reason and returns true.
+    bool RejectIfCancelled(const Napi::Promise::Deferred& deferred) {
+        if (signal_.IsEmpty()) {
+            return false;
+        }
+
+        Napi::Object signal = signal_.Value();
+        if (!listener_.IsEmpty()) {
+            Napi::Env env = signal.Env();
+            signal.Get("removeEventListener").As<Napi::Function>().Call(signal, { Napi::String::New(env, "abort"), listener_.Value() });
+            listener_.Reset();
+        }
+        if (!cancellation_->cancelled()) {
+            return false;
+        }
+        deferred.Reject(signal.Get("reason"));
+        return true;
+    }
+
+    // The environment is gone; its references must not be released from here
+    void Abandon() {
+        signal_.SuppressDestruct();
+        listener_.SuppressDestruct();
+    }
+
+private:
+    CancellationPtr cancellation_;
+    Napi::ObjectReference signal_;
+    Napi::FunctionReference listener_;
+};
+
+// Runs a public key operation on the libuv thread pool and settles a Promise
+// with the resulting key in the configured format, or null on failure (same
+// contract as the sync API). A task cancelled before it committed rejects.
+class KeyPromiseWorker : public Napi::AsyncWorker {
+public:
+    using Task = std::function<std::optional<std::string>()>;
+
+    KeyPromiseWorker(Napi::Env env, Task task, AbortListener abort)
+        : Napi::AsyncWorker(env, "KeysGeneratorAsync"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          task_(std::move(task)),
+          abort_(std::move(abort)),
+          format_(keyFormat.load()) {}
+
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        if (abort_.cancellation()->cancelled()) {
+            return;
+        }
+        try {
+            result_ = ConvertKey(task_(), false, format_);
+        } catch (...) {
+            // Silent failure, resolved as null
+            result_ = std::nullopt;
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (abort_.RejectIfCancelled(deferred_)) {
+            return;
+        }
+        if (result_.has_value()) {
+            deferred_.Resolve(KeyToValue(env, std::move(result_.value()), format_));
         } else {
-            keyLength = PlatformUtils::getRSAKeyLength();
+            deferred_.Resolve(env.Null());
+        }
+    }
+
+    void OnError(const Napi::Error& error) override {
+        if (!abort_.RejectIfCancelled(deferred_)) {
+            deferred_.Reject(error.Value());
         }
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Task task_;
+    AbortListener abort_;
+    KeyFormat format_;
+    std::optional<std::string> result_;
+};
+
+static Napi::Value QueueKeyTask(Napi::Env env, KeyPromiseWorker::Task task, AbortListener abort) {
+    auto* worker = new KeyPromiseWorker(env, std::move(task), std::move(abort));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+struct KeyringRead;
+
+// The keyring thread's way back to one environment's JS thread. That thread
+// outlives every environment but the last (worker threads come and go), so
+// it must stop calling into an environment once its teardown began.
+struct KeyringCompletions {
+    std::mutex mutex;
+    bool closed = false;
+    // Only keeps the event loop alive while reads are pending
+    Napi::ThreadSafeFunction function;
+
+    // False if the environment is gone; read then still belongs to the caller
+    bool Deliver(KeyringRead* read);
 
-        // Replicate the exact Python logic
-        std::optional<KeyPair> keys;
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+};
+
+// Per-environment state of the addon
+struct AddonData {
+    std::shared_ptr<KeyringCompletions> keyringCompletions;
+    size_t pendingKeyringReads = 0;
+};
+
+// A keychain read travelling back from the keyring thread
+struct KeyringRead {
+    Napi::Promise::Deferred deferred;
+    bool privateKey;
+    KeyFormat format;
+    AbortListener abort;
+    std::optional<std::string> value;
+};
+
+// Runs on the JS thread; env is null when the environment is being torn down
+static void SettleKeyringRead(Napi::Env env, Napi::Function, KeyringRead* read) {
+    std::unique_ptr<KeyringRead> owned(read);
+    if (env == nullptr) {
+        owned->abort.Abandon();
+        return;
+    }
+
+    if (owned->abort.RejectIfCancelled(owned->deferred)) {
+        // Cancelling settled the read without waiting for the keychain
+    } else if (owned->value.has_value()) {
+        // Already converted off the JS thread
+        owned->deferred.Resolve(KeyToValue(env, std::move(owned->value.value()), owned->format));
+    } else {
+        owned->deferred.Resolve(env.Null());
+    }
+
+    AddonData* data = env.GetInstanceData<AddonData>();
+    if (--data->pendingKeyringReads == 0) {
+        data->keyringCompletions->function.Unref(env);
+    }
+}
+
+bool KeyringCompletions::Deliver(KeyringRead* read) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !closed && function.NonBlockingCall(read, SettleKeyringRead) == napi_ok;
+}
+
+// Reads a stored key without occupying a libuv pool thread: the lookup runs
+// on the keyring thread and its completion comes back through the shared
+// thread-safe function, so outstanding reads cost no threads at all
+static Napi::Value QueueKeyringRead(Napi::Env env, const std::string& serviceName, bool privateKey,
+                                    AbortListener abort) {
+    AddonData* data = env.GetInstanceData<AddonData>();
+    auto* read = new KeyringRead{ Napi::Promise::Deferred::New(env), privateKey, keyFormat.load(), std::move(abort),
+                                  std::nullopt };
+    Napi::Promise promise = read->deferred.Promise();
+
+    if (data->pendingKeyringReads++ == 0) {
+        data->keyringCompletions->function.Ref(env);
+    }
 
-        if (PlatformUtils::getPlatform() == Platform::Windows) {
-            // Windows always uses 1024 due to issue #105
-            keys = RSAGenerator::getOrGenerateKeys(serviceName, 1024);
+    std::shared_ptr<KeyringCompletions> completions = data->keyringCompletions;
+    CancellationPtr cancellation = read->abort.cancellation();
+    RSAGenerator::getStoredKeyAsync(serviceName, privateKey, [completions, read](std::optional<std::string> value) {
+        read->value = std::move(value);
+        auto deliver = [completions, read]() {
+            // Decoding and re-encoding is CPU work only, the JS thread gets
+            // the finished key
+            read->value = ConvertKey(std::move(read->value), read->privateKey, read->format);
+            if (!completions->Deliver(read)) {
+                // The environment is already gone
+                read->abort.Abandon();
+                delete read;
+            }
+        };
+
+        // Cache hits and pending writes complete on the calling thread
+        if (read->value.has_value() && read->format != KeyFormat::Pkcs1Pem &&
+            !KeyringExecutor::instance().onExecutorThread()) {
+            KeyringExecutor::instance().post(std::move(deliver));
         } else {
+            deliver();
+        }
+    }, cancellation);
+    return promise;
+}
+
+// Validates the required serviceName argument, throwing a TypeError if missing
+static bool ReadServiceName(const Napi::CallbackInfo& info, std::string& serviceName) {
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(info.Env(), "serviceName (string) is required as first parameter")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+
+    serviceName = info[0].As<Napi::String>().Utf8Value();
+    return true;
+}
+
+// Get or generate keys for serviceName, returning the public key
+static std::optional<std::string> GetOrGeneratePublicKey(const std::string& serviceName, int keyLength) {
+    // Replicate the exact Python logic
+    std::optional<KeyPair> keys;
+
+    if (PlatformUtils::getPlatform() == Platform::Windows) {
+        // Windows always uses 1024 due to issue #105
+        keys = RSAGenerator::getOrGenerateKeys(serviceName, 1024);
+    } else {
+        try {
+            keys = RSAGenerator::getOrGenerateKeys(serviceName, keyLength);
+        } catch (...) {
+            // Fall back to 1024 if initial attempt fails
             try {
-                keys = RSAGenerator::getOrGenerateKeys(serviceName, keyLength);
+                keys = RSAGenerator::getOrGenerateKeys(serviceName, 1024);
             } catch (...) {
-                // Fall back to 1024 if initial attempt fails
-                try {
-                    keys = RSAGenerator::getOrGenerateKeys(serviceName, 1024);
-                } catch (...) {
-                    // Silent failure like Python version
-                    return env.Null();
-                }
+                // Silent failure like Python version
+                return std::nullopt;
             }
         }
+    }
 
-        if (keys.has_value()) {
-            return Napi::String::New(env, keys->publicKey);
+    if (keys.has_value()) {
+        return std::move(keys->publicKey);
+    }
+
+    return std::nullopt;
+}
+
+// Force regeneration for serviceName, returning the new public key
+static std::optional<std::string> RegeneratePublicKey(const std::string& serviceName, int keyLength,
+                                                      const CancellationPtr& cancellation = nullptr) {
+    auto keys = RSAGenerator::regenerateKeys(serviceName, keyLength, cancellation);
+    if (keys.has_value()) {
+        return std::move(keys->publicKey);
+    }
+
+    return std::nullopt;
+}
+
+// keyLength for generateKeys: explicit argument, else RSA_KEY_LENGTH env var or 2048
+static int ReadGenerateKeyLength(const Napi::CallbackInfo& info) {
+    if (info.Length() > 1 && info[1].IsNumber()) {
+        return info[1].As<Napi::Number>().Int32Value();
+    }
+
+    return PlatformUtils::getRSAKeyLength();
+}
+
+// keyLength for regenerateKeys: explicit argument, else 2048
+static int ReadRegenerateKeyLength(const Napi::CallbackInfo& info) {
+    if (info.Length() > 1 && info[1].IsNumber()) {
+        return info[1].As<Napi::Number>().Int32Value();
+    }
+
+    return 2048;
+}
+
+// Generate RSA keys and return the public key
+Napi::Value GenerateKeys(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    try {
+        // serviceName is required (first parameter)
+        std::string serviceName;
+        if (!ReadServiceName(info, serviceName)) {
+            return env.Null();
+        }
+
+        // keyLength is optional (second parameter)
+        int keyLength = ReadGenerateKeyLength(info);
+
+        KeyFormat format = keyFormat.load();
+        auto publicKey = ConvertKey(GetOrGeneratePublicKey(serviceName, keyLength), false, format);
+        if (publicKey.has_value()) {
+            return KeyToValue(env, std::move(publicKey.value()), format);
         }
 
     } catch (...) {
@@ -58,6 +407,31 @@ Napi::Value GenerateKeys(const Napi::CallbackInfo& info) {
     return env.Null();
 }
 
+// Async variant of generateKeys, resolves with the public key or null
+Napi::Value GenerateKeysAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::string serviceName;
+    if (!ReadServiceName(info, serviceName)) {
+        return env.Null();
+    }
+
+    int keyLength = ReadGenerateKeyLength(info);
+    AbortListener abort;
+    if (!abort.Attach(env, info[2])) {
+        return env.Null();
+    }
+
+    CancellationPtr cancellation = abort.cancellation();
+    return QueueKeyTask(env, [serviceName, keyLength, cancellation]() -> std::optional<std::string> {
+        // May generate and store; an abort from here on is ignored
+        if (!cancellation->commit()) {
+            return std::nullopt;
+        }
+        return GetOrGeneratePublicKey(serviceName, keyLength);
+    }, std::move(abort));
+}
+
 // Get the stored public key without generating new ones
 Napi::Value GetPublicKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
@@ -70,15 +444,11 @@ Napi::Value GetPublicKey(const Napi::CallbackInfo& info) {
             return env.Null();
         }
 
-        if (!Keyring::isAvailable()) {
-            return env.Null();
-        }
-
         std::string serviceName = info[0].As<Napi::String>().Utf8Value();
-        std::string publicKeyService = serviceName + "PublicKey";
-        auto publicKey = Keyring::getPassword(publicKeyService, "key");
+        KeyFormat format = keyFormat.load();
+        auto publicKey = ConvertKey(RSAGenerator::getStoredPublicKey(serviceName), false, format);
         if (publicKey.has_value()) {
-            return Napi::String::New(env, publicKey.value());
+            return KeyToValue(env, std::move(publicKey.value()), format);
         }
     } catch (...) {
         // Silent failure
@@ -87,6 +457,23 @@ Napi::Value GetPublicKey(const Napi::CallbackInfo& info) {
     return env.Null();
 }
 
+// Async variant of getPublicKey, resolves with the stored public key or null
+Napi::Value GetPublicKeyAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::string serviceName;
+    if (!ReadServiceName(info, serviceName)) {
+        return env.Null();
+    }
+
+    AbortListener abort;
+    if (!abort.Attach(env, info[1])) {
+        return env.Null();
+    }
+
+    return QueueKeyringRead(env, serviceName, false, std::move(abort));
+}
+
 // Get the stored private key
 Napi::Value GetPrivateKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
@@ -99,15 +486,11 @@ Napi::Value GetPrivateKey(const Napi::CallbackInfo& info) {
             return env.Null();
         }
 
-        if (!Keyring::isAvailable()) {
-            return env.Null();
-        }
-
         std::string serviceName = info[0].As<Napi::String>().Utf8Value();
-        std::string privateKeyService = serviceName + "PrivateKey";
-        auto privateKey = Keyring::getPassword(privateKeyService, "key");
+        KeyFormat format = keyFormat.load();
+        auto privateKey = ConvertKey(RSAGenerator::getStoredPrivateKey(serviceName), true, format);
         if (privateKey.has_value()) {
-            return Napi::String::New(env, privateKey.value());
+            return KeyToValue(env, std::move(privateKey.value()), format);
         }
     } catch (...) {
         // Silent failure
@@ -116,6 +499,23 @@ Napi::Value GetPrivateKey(const Napi::CallbackInfo& info) {
     return env.Null();
 }
 
+// Async variant of getPrivateKey, resolves with the stored private key or null
+Napi::Value GetPrivateKeyAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::string serviceName;
+    if (!ReadServiceName(info, serviceName)) {
+        return env.Null();
+    }
+
+    AbortListener abort;
+    if (!abort.Attach(env, info[1])) {
+        return env.Null();
+    }
+
+    return QueueKeyringRead(env, serviceName, true, std::move(abort));
+}
+
 // Check if keyring is available
 Napi::Value IsKeychainAvailable(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
@@ -128,54 +528,433 @@ Napi::Value GetPlatform(const Napi::CallbackInfo& info) {
     return Napi::String::New(env, PlatformUtils::getPlatformString());
 }
 
-// Clear stored keys from keychain
+// Delete the stored keys of one service from the keychain
 Napi::Value ClearKeys(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     try {
-        if (!Keyring::isAvailable()) {
-            return Napi::Boolean::New(env, false);
+        std::string serviceName;
+        if (!ReadServiceName(info, serviceName)) {
+            return env.Null();
         }
 
-        // For clearing, we'd need to implement deletion methods in Keyring class
-        // For now, return false as this feature wasn't in the original Python version
-        return Napi::Boolean::New(env, false);
+        return Napi::Boolean::New(env, RSAGenerator::clearKeys(serviceName) > 0);
     } catch (...) {
         return Napi::Boolean::New(env, false);
     }
 }
 
+// Reads the non-empty service name prefix (first parameter); throws on error
+static bool ReadPrefix(const Napi::CallbackInfo& info, std::string& prefix) {
+    // An empty prefix would match every service
+    if (info.Length() < 1 || !info[0].IsString() || info[0].As<Napi::String>().Utf8Value().empty()) {
+        Napi::TypeError::New(info.Env(), "prefix (non-empty string) is required as first parameter")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+    prefix = info[0].As<Napi::String>().Utf8Value();
+    return true;
+}
+
+// Delete the stored keys of every service whose name starts with a prefix
+Napi::Value ClearKeysByPrefix(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::string prefix;
+    if (!ReadPrefix(info, prefix)) {
+        return env.Null();
+    }
+
+    try {
+        return Napi::Number::New(env, RSAGenerator::clearKeysByPrefix(prefix));
+    } catch (...) {
+        return Napi::Number::New(env, -1);
+    }
+}
+
+// Deletes by prefix on the libuv thread pool; the search and deletes run on
+// the keyring thread. Resolves with the same count as clearKeysByPrefix.
+class ClearByPrefixWorker : public Napi::AsyncWorker {
+public:
+    ClearByPrefixWorker(Napi::Env env, std::string prefix, AbortListener abort)
+        : Napi::AsyncWorker(env, "KeysGeneratorClearByPrefix"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          prefix_(std::move(prefix)),
+          abort_(std::move(abort)) {}
+
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        // Deletes from here on; an abort after this point is ignored
+        if (!abort_.cancellation()->commit()) {
+            return;
+        }
+        try {
+            removed_ = RSAGenerator::clearKeysByPrefix(prefix_);
+        } catch (...) {
+            removed_ = -1;
+        }
+    }
+
+    void OnOK() override {
+        if (!abort_.RejectIfCancelled(deferred_)) {
+            deferred_.Resolve(Napi::Number::New(Env(), removed_));
+        }
+    }
+
+    void OnError(const Napi::Error& error) override {
+        if (!abort_.RejectIfCancelled(deferred_)) {
+            deferred_.Reject(error.Value());
+        }
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    std::string prefix_;
+    AbortListener abort_;
+    int removed_ = -1;
+};
+
+// Async variant of clearKeysByPrefix
+Napi::Value ClearKeysByPrefixAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::string prefix;
+    if (!ReadPrefix(info, prefix)) {
+        return env.Null();
+    }
+
+    AbortListener abort;
+    if (!abort.Attach(env, info[1])) {
+        return env.Null();
+    }
+
+    auto* worker = new ClearByPrefixWorker(env, std::move(prefix), std::move(abort));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
 // Force regenerate keys with specific length
 Napi::Value RegenerateKeys(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     try {
         // serviceName is required (first parameter)
-        if (info.Length() < 1 || !info[0].IsString()) {
-            Napi::TypeError::New(env, "serviceName (string) is required as first parameter")
-                .ThrowAsJavaScriptException();
+        std::string serviceName;
+        if (!ReadServiceName(info, serviceName)) {
             return env.Null();
         }
 
-        std::string serviceName = info[0].As<Napi::String>().Utf8Value();
-
         // keyLength is optional (second parameter)
-        int keyLength = 2048; // default
-        if (info.Length() > 1 && info[1].IsNumber()) {
-            keyLength = info[1].As<Napi::Number>().Int32Value();
+        int keyLength = ReadRegenerateKeyLength(info);
+
+        KeyFormat format = keyFormat.load();
+        auto publicKey = ConvertKey(RegeneratePublicKey(serviceName, keyLength), false, format);
+        if (publicKey.has_value()) {
+            return KeyToValue(env, std::move(publicKey.value()), format);
         }
+    } catch (...) {
+        // Silent failure
+    }
 
-        // Generate new keys (not retrieve existing)
-        auto keys = RSAGenerator::generateKeys(keyLength);
-        if (keys.has_value()) {
-            // Store in keyring
-            if (Keyring::isAvailable()) {
-                std::string publicKeyService = serviceName + "PublicKey";
-                std::string privateKeyService = serviceName + "PrivateKey";
-                Keyring::setPassword(publicKeyService, "key", keys->publicKey);
-                Keyring::setPassword(privateKeyService, "key", keys->privateKey);
+    return env.Null();
+}
+
+// Async variant of regenerateKeys, resolves with the new public key or null
+Napi::Value RegenerateKeysAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::string serviceName;
+    if (!ReadServiceName(info, serviceName)) {
+        return env.Null();
+    }
+
+    int keyLength = ReadRegenerateKeyLength(info);
+    AbortListener abort;
+    if (!abort.Attach(env, info[2])) {
+        return env.Null();
+    }
+
+    // Commits once the new pair is generated, right before it is stored
+    CancellationPtr cancellation = abort.cancellation();
+    return QueueKeyTask(env, [serviceName, keyLength, cancellation]() {
+        return RegeneratePublicKey(serviceName, keyLength, cancellation);
+    }, std::move(abort));
+}
+
+static Napi::Object KeyPairToObject(Napi::Env env, KeyPair keys) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("publicKey", KeyToValue(env, std::move(keys.publicKey), keys.format));
+    result.Set("privateKey", KeyToValue(env, std::move(keys.privateKey), keys.format));
+    return result;
+}
+
+// Reads the stored keys of many services on the libuv thread pool. Resolves
+// with one {publicKey, privateKey} or null per service, or with the number of
+// services found when only warming the cache.
+class BulkKeysWorker : public Napi::AsyncWorker {
+public:
+    BulkKeysWorker(Napi::Env env, std::vector<std::string> serviceNames, bool countOnly, AbortListener abort)
+        : Napi::AsyncWorker(env, "KeysGeneratorBulkRead"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          serviceNames_(std::move(serviceNames)),
+          countOnly_(countOnly),
+          abort_(std::move(abort)),
+          format_(keyFormat.load()) {}
+
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        // Aborted while queued: skip the keyring pass
+        if (abort_.cancellation()->cancelled()) {
+            return;
+        }
+        try {
+            keys_ = RSAGenerator::getStoredKeysBulk(serviceNames_);
+            if (!countOnly_) {
+                for (auto& keys : keys_) {
+                    if (keys.has_value()) {
+                        keys = RSAGenerator::convertKeyPair(std::move(keys.value()), format_);
+                    }
+                }
+            }
+        } catch (...) {
+            // Silent failure, every service resolves as not found
+            keys_.assign(serviceNames_.size(), std::nullopt);
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (abort_.RejectIfCancelled(deferred_)) {
+            return;
+        }
+        if (countOnly_) {
+            size_t found = 0;
+            for (const auto& keys : keys_) {
+                found += keys.has_value() ? 1 : 0;
             }
-            return Napi::String::New(env, keys->publicKey);
+            deferred_.Resolve(Napi::Number::New(env, static_cast<double>(found)));
+            return;
+        }
+
+        Napi::Array result = Napi::Array::New(env, keys_.size());
+        for (size_t i = 0; i < keys_.size(); i++) {
+            if (keys_[i].has_value()) {
+                result.Set(static_cast<uint32_t>(i), KeyPairToObject(env, std::move(keys_[i].value())));
+            } else {
+                result.Set(static_cast<uint32_t>(i), env.Null());
+            }
+        }
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        if (!abort_.RejectIfCancelled(deferred_)) {
+            deferred_.Reject(error.Value());
+        }
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    std::vector<std::string> serviceNames_;
+    bool countOnly_;
+    AbortListener abort_;
+    KeyFormat format_;
+    std::vector<std::optional<KeyPair>> keys_;
+};
+
+// Validates the required serviceNames array, throwing a TypeError if invalid
+static bool ReadServiceNames(const Napi::CallbackInfo& info, std::vector<std::string>& serviceNames) {
+    if (info.Length() > 0 && info[0].IsArray()) {
+        Napi::Array names = info[0].As<Napi::Array>();
+        serviceNames.reserve(names.Length());
+        for (uint32_t i = 0; i < names.Length(); i++) {
+            Napi::Value name = names.Get(i);
+            if (!name.IsString()) {
+                break;
+            }
+            serviceNames.push_back(name.As<Napi::String>().Utf8Value());
+        }
+        if (serviceNames.size() == names.Length()) {
+            return true;
+        }
+    }
+
+    Napi::TypeError::New(info.Env(), "serviceNames (array of strings) is required as first parameter")
+        .ThrowAsJavaScriptException();
+    return false;
+}
+
+static Napi::Value QueueBulkRead(const Napi::CallbackInfo& info, bool countOnly) {
+    Napi::Env env = info.Env();
+
+    std::vector<std::string> serviceNames;
+    if (!ReadServiceNames(info, serviceNames)) {
+        return env.Null();
+    }
+
+    AbortListener abort;
+    if (!abort.Attach(env, info[1])) {
+        return env.Null();
+    }
+
+    auto* worker = new BulkKeysWorker(env, std::move(serviceNames), countOnly, std::move(abort));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+// Stored keys of many services from one keyring pass
+Napi::Value GetKeysBulk(const Napi::CallbackInfo& info) {
+    return QueueBulkRead(info, false);
+}
+
+// Warm the keyring cache for many services with one keyring pass
+Napi::Value Prefetch(const Napi::CallbackInfo& info) {
+    return QueueBulkRead(info, true);
+}
+
+// Reads an optional non-negative integer property from an options object;
+// values above max throw a RangeError
+static bool ReadSizeOption(const Napi::Object& options, const char* name, size_t& value,
+                           double max = 9007199254740991.0) {
+    if (!options.Has(name)) {
+        return true;
+    }
+
+    Napi::Value raw = options.Get(name);
+    if (raw.IsUndefined()) {
+        return true;
+    }
+    if (!raw.IsNumber() || raw.As<Napi::Number>().DoubleValue() < 0) {
+        Napi::TypeError::New(options.Env(), std::string(name) + " must be a non-negative number")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+    if (!(raw.As<Napi::Number>().DoubleValue() <= max)) {
+        Napi::RangeError::New(options.Env(), std::string(name) + " must not exceed " + std::to_string(static_cast<int64_t>(max)))
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+
+    value = static_cast<size_t>(raw.As<Napi::Number>().Int64Value());
+    return true;
+}
+
+// Reads an optional boolean property from an options object
+static bool ReadBoolOption(const Napi::Object& options, const char* name, bool& value) {
+    if (!options.Has(name)) {
+        return true;
+    }
+
+    Napi::Value raw = options.Get(name);
+    if (raw.IsUndefined()) {
+        return true;
+    }
+    if (!raw.IsBoolean()) {
+        Napi::TypeError::New(options.Env(), std::string(name) + " must be a boolean")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+
+    value = raw.As<Napi::Boolean>().Value();
+    return true;
+}
+
+// Public exponent argument: an odd number >= 3, default 65537
+static bool ReadPublicExponent(Napi::Env env, const Napi::Value& raw, unsigned long& exponent) {
+    exponent = RSAGenerator::kDefaultPublicExponent;
+    if (raw.IsUndefined() || raw.IsNull()) {
+        return true;
+    }
+
+    int64_t value = raw.IsNumber() ? raw.As<Napi::Number>().Int64Value() : 0;
+    if (value < 3 || value % 2 == 0) {
+        Napi::TypeError::New(env, "publicExponent must be an odd number >= 3")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+
+    exponent = static_cast<unsigned long>(value);
+    return true;
+}
+
+// Throws a RangeError unless keyLength is one RSAGenerator accepts
+static bool CheckKeyLength(Napi::Env env, int64_t keyLength) {
+    if (keyLength < RSAGenerator::kMinKeyLength || keyLength > RSAGenerator::kMaxKeyLength) {
+        Napi::RangeError::New(env, "keyLength must be between " + std::to_string(RSAGenerator::kMinKeyLength) +
+            " and " + std::to_string(RSAGenerator::kMaxKeyLength))
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+    return true;
+}
+
+// Configure a background key pool for one (keyLength, publicExponent) pair
+Napi::Value ConfigureKeyPool(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "options (object) is required as first parameter")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Object options = info[0].As<Napi::Object>();
+    KeyPoolConfig config;
+
+    size_t keyLength = static_cast<size_t>(config.keyLength);
+    size_t threads = 0;
+    if (!ReadSizeOption(options, "keyLength", keyLength) ||
+        !ReadSizeOption(options, "lowWatermark", config.lowWatermark) ||
+        !ReadSizeOption(options, "highWatermark", config.highWatermark) ||
+        !ReadSizeOption(options, "threads", threads) ||
+        !ReadPublicExponent(env, options.Get("publicExponent"), config.publicExponent)) {
+        return env.Undefined();
+    }
+    if (!CheckKeyLength(env, static_cast<int64_t>(keyLength))) {
+        return env.Undefined();
+    }
+    config.keyLength = static_cast<int>(keyLength);
+
+    if (threads > 0) {
+        KeyPool::setRefillThreads(threads);
+    }
+    KeyPool::configure(config);
+
+    return env.Undefined();
+}
+
+// Take a pre-generated key pair from the pool, null on a miss
+Napi::Value TakeKey(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    int keyLength = 2048;
+    if (info.Length() > 0 && info[0].IsNumber()) {
+        int64_t requested = info[0].As<Napi::Number>().Int64Value();
+        if (!CheckKeyLength(env, requested)) {
+            return env.Null();
+        }
+        keyLength = static_cast<int>(requested);
+    }
+
+    unsigned long publicExponent = RSAGenerator::kDefaultPublicExponent;
+    if (info.Length() > 1 && !ReadPublicExponent(env, info[1], publicExponent)) {
+        return env.Null();
+    }
+
+    try {
+        // Never generates: that would block the JS thread for seconds
+        auto keys = KeyPool::tryTake(keyLength, publicExponent);
+        if (keys.has_value()) {
+            keys = RSAGenerator::convertKeyPair(std::move(keys.value()), keyFormat.load());
+        }
+        if (keys.has_value()) {
+            return KeyPairToObject(env, std::move(keys.value()));
         }
     } catch (...) {
         // Silent failure
@@ -184,6 +963,564 @@ Napi::Value RegenerateKeys(const Napi::CallbackInfo& info) {
     return env.Null();
 }
 
+// Get depth and hit/miss counters for every configured pool
+Napi::Value GetKeyPoolStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto stats = KeyPool::getStats();
+    Napi::Array result = Napi::Array::New(env, stats.size());
+    for (size_t i = 0; i < stats.size(); i++) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("keyLength", Napi::Number::New(env, stats[i].keyLength));
+        item.Set("publicExponent", Napi::Number::New(env, static_cast<double>(stats[i].publicExponent)));
+        item.Set("available", Napi::Number::New(env, static_cast<double>(stats[i].available)));
+        item.Set("lowWatermark", Napi::Number::New(env, static_cast<double>(stats[i].lowWatermark)));
+        item.Set("highWatermark", Napi::Number::New(env, static_cast<double>(stats[i].highWatermark)));
+        item.Set("hits", Napi::Number::New(env, static_cast<double>(stats[i].hits)));
+        item.Set("misses", Napi::Number::New(env, static_cast<double>(stats[i].misses)));
+        item.Set("generated", Napi::Number::New(env, static_cast<double>(stats[i].generated)));
+        item.Set("refilling", Napi::Boolean::New(env, stats[i].refilling));
+        item.Set("failed", Napi::Boolean::New(env, stats[i].failed));
+        result.Set(static_cast<uint32_t>(i), item);
+    }
+
+    return result;
+}
+
+// Generates a batch of key pairs on the shared native thread pool. Completed
+// pairs are streamed to onChunk in groups of chunkSize when a callback is
+// given, otherwise collected and returned with the throughput summary.
+class BatchWorker : public Napi::AsyncProgressQueueWorker<KeyPair> {
+public:
+    BatchWorker(Napi::Env env, size_t count, int keyLength, unsigned long publicExponent,
+                size_t concurrency, size_t chunkSize, Napi::Function onChunk)
+        : Napi::AsyncProgressQueueWorker<KeyPair>(env, "KeysGeneratorBatch"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          count_(count),
+          keyLength_(keyLength),
+          publicExponent_(publicExponent),
+          concurrency_(concurrency),
+          chunkSize_(chunkSize > 0 ? chunkSize : 1),
+          format_(keyFormat.load()) {
+        if (!onChunk.IsEmpty()) {
+            onChunk_ = Napi::Persistent(onChunk);
+        }
+    }
+
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+protected:
+    void Execute(const ExecutionProgress& progress) override {
+        auto start = std::chrono::steady_clock::now();
+        bool streaming = !onChunk_.IsEmpty();
+
+        std::vector<KeyPair> chunk;
+        RSAGenerator::generateKeysBatch(count_, keyLength_, publicExponent_, concurrency_, format_,
+            [&](std::optional<KeyPair> keys) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!keys.has_value()) {
+                    failed_++;
+                    return;
+                }
+                succeeded_++;
+
+                if (!streaming) {
+                    keys_.push_back(std::move(keys.value()));
+                    return;
+                }
+
+                chunk.push_back(std::move(keys.value()));
+                if (chunk.size() >= chunkSize_) {
+                    progress.Send(chunk.data(), chunk.size());
+                    chunk.clear();
+                }
+            });
+
+        if (!chunk.empty()) {
+            progress.Send(chunk.data(), chunk.size());
+        }
+
+        elapsedMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void OnProgress(const KeyPair* data, size_t count) override {
+        Napi::Env env = Env();
+        if (onChunk_.IsEmpty() || data == nullptr) {
+            return;
+        }
+
+        Napi::Array keys = Napi::Array::New(env, count);
+        for (size_t i = 0; i < count; i++) {
+            keys.Set(static_cast<uint32_t>(i), KeyPairToObject(env, data[i]));
+        }
+        onChunk_.Value().Call({ keys });
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("count", Napi::Number::New(env, static_cast<double>(succeeded_)));
+        result.Set("failed", Napi::Number::New(env, static_cast<double>(failed_)));
+        result.Set("elapsedMs", Napi::Number::New(env, elapsedMs_));
+        result.Set("keysPerSecond", Napi::Number::New(env, elapsedMs_ > 0 ? succeeded_ * 1000.0 / elapsedMs_ : 0));
+        result.Set("threads", Napi::Number::New(env, static_cast<double>(
+            concurrency_ > 0 && concurrency_ < ThreadPool::shared().size() ? concurrency_ : ThreadPool::shared().size())));
+
+        if (onChunk_.IsEmpty()) {
+            Napi::Array keys = Napi::Array::New(env, keys_.size());
+            for (size_t i = 0; i < keys_.size(); i++) {
+                keys.Set(static_cast<uint32_t>(i), KeyPairToObject(env, std::move(keys_[i])));
+            }
+            result.Set("keys", keys);
+        }
+
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::FunctionReference onChunk_;
+    size_t count_;
+    int keyLength_;
+    unsigned long publicExponent_;
+    size_t concurrency_;
+    size_t chunkSize_;
+    KeyFormat format_;
+
+    std::mutex mutex_;
+    std::vector<KeyPair> keys_;
+    size_t succeeded_ = 0;
+    size_t failed_ = 0;
+    double elapsedMs_ = 0;
+};
+
+// Upper bound on one batch; without onChunk every pair is held until the
+// batch resolves
+static const size_t kMaxBatchCount = 100000;
+
+// Generate many key pairs in parallel across all cores
+Napi::Value GenerateKeysBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber() || info[0].As<Napi::Number>().Int64Value() < 0) {
+        Napi::TypeError::New(env, "count (non-negative number) is required as first parameter")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    size_t count = static_cast<size_t>(info[0].As<Napi::Number>().Int64Value());
+    if (count > kMaxBatchCount) {
+        Napi::RangeError::New(env, "count must be at most " + std::to_string(kMaxBatchCount))
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    int keyLength = 2048;
+    if (info.Length() > 1 && info[1].IsNumber()) {
+        int64_t requested = info[1].As<Napi::Number>().Int64Value();
+        if (!CheckKeyLength(env, requested)) {
+            return env.Null();
+        }
+        keyLength = static_cast<int>(requested);
+    }
+
+    unsigned long publicExponent = RSAGenerator::kDefaultPublicExponent;
+    size_t concurrency = 0;
+    size_t chunkSize = 16;
+    Napi::Function onChunk;
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object options = info[2].As<Napi::Object>();
+        if (!ReadSizeOption(options, "concurrency", concurrency) ||
+            !ReadSizeOption(options, "chunkSize", chunkSize) ||
+            !ReadPublicExponent(env, options.Get("publicExponent"), publicExponent)) {
+            return env.Null();
+        }
+
+        Napi::Value callback = options.Get("onChunk");
+        if (callback.IsFunction()) {
+            onChunk = callback.As<Napi::Function>();
+        } else if (!callback.IsUndefined()) {
+            Napi::TypeError::New(env, "onChunk must be a function")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+
+    auto* worker = new BatchWorker(env, count, keyLength, publicExponent, concurrency, chunkSize, onChunk);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+// Apply module-wide settings; options that are not given keep their value
+Napi::Value Configure(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "options (object) is required as first parameter")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Object options = info[0].As<Napi::Object>();
+
+    if (options.Has("parallelKeygen") || options.Has("parallelKeygenThreads")) {
+        bool parallelKeygen = RSAGenerator::isParallelKeygenEnabled();
+        size_t parallelKeygenThreads = RSAGenerator::getParallelKeygenThreads();
+        if (!ReadBoolOption(options, "parallelKeygen", parallelKeygen) ||
+            !ReadSizeOption(options, "parallelKeygenThreads", parallelKeygenThreads)) {
+            return env.Undefined();
+        }
+        RSAGenerator::setParallelKeygen(parallelKeygen, parallelKeygenThreads);
+    }
+
+    if (options.Has("isolatedCryptoContexts")) {
+        bool isolated = false;
+        if (!ReadBoolOption(options, "isolatedCryptoContexts", isolated)) {
+            return env.Undefined();
+        }
+        RSAGenerator::setIsolatedLibraryContexts(isolated);
+    }
+
+    if (options.Has("crossProcessLock") || options.Has("crossProcessLockTimeoutMs")) {
+        bool crossProcessLock = RSAGenerator::isProcessLockEnabled();
+        size_t timeoutMs = static_cast<size_t>(RSAGenerator::getProcessLockTimeoutMs());
+        if (!ReadBoolOption(options, "crossProcessLock", crossProcessLock) ||
+            !ReadSizeOption(options, "crossProcessLockTimeoutMs", timeoutMs, INT_MAX)) {
+            return env.Undefined();
+        }
+        RSAGenerator::setProcessLock(crossProcessLock, static_cast<int>(timeoutMs));
+    }
+
+    if (options.Has("writeBehind") || options.Has("writeBehindRetries") ||
+        options.Has("writeBehindRetryDelayMs")) {
+        bool writeBehind = WriteBehind::enabled();
+        size_t retries = 0;
+        size_t retryDelayMs = 0;
+        if (!ReadBoolOption(options, "writeBehind", writeBehind) ||
+            !ReadSizeOption(options, "writeBehindRetries", retries, INT_MAX) ||
+            !ReadSizeOption(options, "writeBehindRetryDelayMs", retryDelayMs, INT_MAX)) {
+            return env.Undefined();
+        }
+        // -1 keeps the current value of options that are not given
+        WriteBehind::configure(writeBehind,
+            options.Get("writeBehindRetries").IsNumber() ? static_cast<int>(retries) : -1,
+            options.Get("writeBehindRetryDelayMs").IsNumber() ? static_cast<int>(retryDelayMs) : -1);
+    }
+
+    if (options.Has("cacheTtlMs") || options.Has("cacheMaxEntries")) {
+        KeyringCacheStats current = Keyring::getCacheStats();
+        size_t ttlMs = static_cast<size_t>(current.ttlMs);
+        size_t maxEntries = current.maxEntries;
+        if (!ReadSizeOption(options, "cacheTtlMs", ttlMs) ||
+            !ReadSizeOption(options, "cacheMaxEntries", maxEntries)) {
+            return env.Undefined();
+        }
+        Keyring::configureCache(maxEntries, static_cast<long long>(ttlMs));
+    }
+
+    if (options.Has("negativeCacheTtlMs")) {
+        size_t negativeTtlMs = 0;
+        if (!ReadSizeOption(options, "negativeCacheTtlMs", negativeTtlMs)) {
+            return env.Undefined();
+        }
+        Keyring::configureNegativeCache(static_cast<long long>(negativeTtlMs));
+    }
+
+    if (options.Has("keyringTimeoutMs") || options.Has("circuitBreakerThreshold") ||
+        options.Has("circuitBreakerCooldownMs")) {
+        size_t timeoutMs = 0;
+        size_t threshold = 0;
+        size_t cooldownMs = 0;
+        if (!ReadSizeOption(options, "keyringTimeoutMs", timeoutMs, INT_MAX) ||
+            !ReadSizeOption(options, "circuitBreakerThreshold", threshold, INT_MAX) ||
+            !ReadSizeOption(options, "circuitBreakerCooldownMs", cooldownMs, INT_MAX)) {
+            return env.Undefined();
+        }
+        // -1 keeps the current value of options that are not given
+        Keyring::configureTimeouts(
+            options.Get("keyringTimeoutMs").IsNumber() ? static_cast<int>(timeoutMs) : -1,
+            options.Get("circuitBreakerThreshold").IsNumber() ? static_cast<int>(threshold) : -1,
+            options.Get("circuitBreakerCooldownMs").IsNumber() ? static_cast<int>(cooldownMs) : -1);
+    }
+
+    if (options.Has("keyringBatchWindowMs")) {
+        size_t windowMs = 0;
+        if (!ReadSizeOption(options, "keyringBatchWindowMs", windowMs, INT_MAX)) {
+            return env.Undefined();
+        }
+        Keyring::setBatchWindow(static_cast<int>(windowMs));
+    }
+
+    if (options.Has("kernelKeyring")) {
+        Napi::Value scope = options.Get("kernelKeyring");
+        std::string name = scope.IsString() ? scope.As<Napi::String>().Utf8Value() : "";
+        if (name == "user") {
+            KernelKeyring::setScope(KernelKeyringScope::User);
+        } else if (name == "session") {
+            KernelKeyring::setScope(KernelKeyringScope::Session);
+        } else if (name == "persistent") {
+            KernelKeyring::setScope(KernelKeyringScope::Persistent);
+        } else {
+            Napi::TypeError::New(env, "kernelKeyring must be 'user', 'session' or 'persistent'")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+
+    if (options.Has("keystorePath")) {
+        Napi::Value path = options.Get("keystorePath");
+        if (!path.IsString() && !path.IsUndefined()) {
+            Napi::TypeError::New(env, "keystorePath must be a string")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        FileKeystore::shared()->setPath(path.IsString() ? path.As<Napi::String>().Utf8Value() : "");
+        if (Keyring::getBackendName() == "file") {
+            Keyring::clearCache();
+        }
+    }
+
+    if (options.Has("keyringBackend")) {
+        Napi::Value backend = options.Get("keyringBackend");
+        std::string name = backend.IsString() ? backend.As<Napi::String>().Utf8Value() : "";
+        if (!Keyring::setBackend(name)) {
+            Napi::TypeError::New(env, "keyringBackend must be 'system', 'kernel', 'memory' or 'file'")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+
+    if (options.Has("keyOutput")) {
+        Napi::Value output = options.Get("keyOutput");
+        std::string name = output.IsString() ? output.As<Napi::String>().Utf8Value() : "";
+        if (name == "string") {
+            keyOutput.store(KeyOutput::String);
+        } else if (name == "buffer") {
+            keyOutput.store(KeyOutput::Buffer);
+        } else {
+            Napi::TypeError::New(env, "keyOutput must be 'string' or 'buffer'")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+
+    if (options.Has("keyFormat")) {
+        Napi::Value format = options.Get("keyFormat");
+        std::string name = format.IsString() ? format.As<Napi::String>().Utf8Value() : "";
+        if (name == "pkcs1-pem") {
+            keyFormat.store(KeyFormat::Pkcs1Pem);
+        } else if (name == "pkcs8-pem") {
+            keyFormat.store(KeyFormat::Pkcs8Pem);
+        } else if (name == "pkcs1-der") {
+            keyFormat.store(KeyFormat::Pkcs1Der);
+        } else if (name == "pkcs8-der") {
+            keyFormat.store(KeyFormat::Pkcs8Der);
+        } else if (name == "raw") {
+            keyFormat.store(KeyFormat::Raw);
+        } else {
+            Napi::TypeError::New(env, "keyFormat must be 'pkcs1-pem', 'pkcs8-pem', 'pkcs1-der', 'pkcs8-der' or 'raw'")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+
+    if (options.Has("storageLayout")) {
+        Napi::Value layout = options.Get("storageLayout");
+        std::string name = layout.IsString() ? layout.As<Napi::String>().Utf8Value() : "";
+        if (name == "split") {
+            RSAGenerator::setStorageLayout(StorageLayout::Split);
+        } else if (name == "packed") {
+            RSAGenerator::setStorageLayout(StorageLayout::Packed);
+        } else {
+            Napi::TypeError::New(env, "storageLayout must be 'split' or 'packed'")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+
+    return env.Undefined();
+}
+
+// Get the name of the active keyring backend
+Napi::Value GetKeyringBackend(const Napi::CallbackInfo& info) {
+    return Napi::String::New(info.Env(), Keyring::getBackendName());
+}
+
+// Get keyring cache size and hit/miss counters
+Napi::Value GetCacheStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    KeyringCacheStats stats = Keyring::getCacheStats();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("entries", Napi::Number::New(env, static_cast<double>(stats.entries)));
+    result.Set("maxEntries", Napi::Number::New(env, static_cast<double>(stats.maxEntries)));
+    result.Set("ttlMs", Napi::Number::New(env, static_cast<double>(stats.ttlMs)));
+    result.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+    result.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+    result.Set("evictions", Napi::Number::New(env, static_cast<double>(stats.evictions)));
+    result.Set("missingEntries", Napi::Number::New(env, static_cast<double>(stats.missingEntries)));
+    result.Set("negativeTtlMs", Napi::Number::New(env, static_cast<double>(stats.negativeTtlMs)));
+    result.Set("negativeHits", Napi::Number::New(env, static_cast<double>(stats.negativeHits)));
+    return result;
+}
+
+// Drop cached keys for one service, or the whole cache without a serviceName
+Napi::Value ClearCache(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() > 0 && info[0].IsString()) {
+        RSAGenerator::invalidateCachedKeys(info[0].As<Napi::String>().Utf8Value());
+    } else {
+        Keyring::clearCache();
+    }
+
+    return env.Undefined();
+}
+
+// Rewrite keychain items stored under the legacy network schema (Linux)
+Napi::Value MigrateLegacyKeychainItems(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    try {
+        return Napi::Number::New(env, Keyring::migrateLegacyItems());
+    } catch (...) {
+        return Napi::Number::New(env, 0);
+    }
+}
+
+// Compacts the file keystore on the keyring thread, behind any reads and
+// writes already queued there. Resolves with its size afterwards, or null if
+// it cannot be opened.
+class CompactWorker : public Napi::AsyncWorker {
+public:
+    explicit CompactWorker(Napi::Env env)
+        : Napi::AsyncWorker(env, "KeysGeneratorCompact"),
+          deferred_(Napi::Promise::Deferred::New(env)) {}
+
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        KeyringExecutor::instance().run([this]() {
+            reclaimed_ = FileKeystore::shared()->compact();
+            if (reclaimed_ >= 0) {
+                stats_ = FileKeystore::shared()->stats();
+            }
+        });
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (reclaimed_ < 0) {
+            deferred_.Resolve(env.Null());
+            return;
+        }
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("path", Napi::String::New(env, stats_.path));
+        result.Set("reclaimedBytes", Napi::Number::New(env, static_cast<double>(reclaimed_)));
+        result.Set("fileBytes", Napi::Number::New(env, static_cast<double>(stats_.fileBytes)));
+        result.Set("liveBytes", Napi::Number::New(env, static_cast<double>(stats_.liveBytes)));
+        result.Set("records", Napi::Number::New(env, static_cast<double>(stats_.records)));
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    long long reclaimed_ = -1;
+    FileKeystoreStats stats_;
+};
+
+// Rewrite the file keystore without superseded records
+Napi::Value CompactKeystore(const Napi::CallbackInfo& info) {
+    auto* worker = new CompactWorker(info.Env());
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+// Waits for write-behind stores on the libuv thread pool. Resolves with true
+// once every store queued before the call is persisted, false if one was
+// given up or the timeout expired.
+class FlushWorker : public Napi::AsyncWorker {
+public:
+    FlushWorker(Napi::Env env, std::chrono::milliseconds timeout)
+        : Napi::AsyncWorker(env, "KeysGeneratorFlush"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          timeout_(timeout) {}
+
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        persisted_ = WriteBehind::flush(timeout_);
+    }
+
+    void OnOK() override {
+        deferred_.Resolve(Napi::Boolean::New(Env(), persisted_));
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    std::chrono::milliseconds timeout_;
+    bool persisted_ = false;
+};
+
+// Durability barrier for keys returned before their keyring write finished
+Napi::Value Flush(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    size_t timeoutMs = 0;
+    if (info.Length() > 0 && !info[0].IsUndefined()) {
+        if (!info[0].IsNumber() || info[0].As<Napi::Number>().DoubleValue() < 0) {
+            Napi::TypeError::New(env, "timeoutMs must be a non-negative number")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        timeoutMs = static_cast<size_t>(info[0].As<Napi::Number>().DoubleValue());
+    }
+
+    auto* worker = new FlushWorker(env, std::chrono::milliseconds(timeoutMs));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+// Whether RSA_KEYS_WARMUP made Init warm OpenSSL up
+static bool warmedUpOnLoad = false;
+
+// Environments (the main thread and worker threads) that loaded the addon
+static std::mutex environmentsMutex;
+static size_t liveEnvironments = 0;
+
+// Initialize OpenSSL now instead of on the first key request, and report
+// what each step cost
+Napi::Value Warmup(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    WarmupStats stats = RSAGenerator::warmup();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("initMs", Napi::Number::New(env, stats.initMs));
+    result.Set("keymgmtMs", Napi::Number::New(env, stats.keymgmtMs));
+    result.Set("encodersMs", Napi::Number::New(env, stats.encodersMs));
+    result.Set("drbgMs", Napi::Number::New(env, stats.drbgMs));
+    result.Set("totalMs", Napi::Number::New(env, stats.totalMs));
+    result.Set("onLoad", Napi::Boolean::New(env, warmedUpOnLoad));
+    return result;
+}
+
 // Initialize the module
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set(Napi::String::New(env, "generateKeys"),
@@ -198,8 +1535,83 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
                 Napi::Function::New(env, GetPlatform));
     exports.Set(Napi::String::New(env, "clearKeys"),
                 Napi::Function::New(env, ClearKeys));
+    exports.Set(Napi::String::New(env, "clearKeysByPrefix"),
+                Napi::Function::New(env, ClearKeysByPrefix));
+    exports.Set(Napi::String::New(env, "clearKeysByPrefixAsync"),
+                Napi::Function::New(env, ClearKeysByPrefixAsync));
     exports.Set(Napi::String::New(env, "regenerateKeys"),
                 Napi::Function::New(env, RegenerateKeys));
+    exports.Set(Napi::String::New(env, "generateKeysAsync"),
+                Napi::Function::New(env, GenerateKeysAsync));
+    exports.Set(Napi::String::New(env, "getPublicKeyAsync"),
+                Napi::Function::New(env, GetPublicKeyAsync));
+    exports.Set(Napi::String::New(env, "getPrivateKeyAsync"),
+                Napi::Function::New(env, GetPrivateKeyAsync));
+    exports.Set(Napi::String::New(env, "getKeysBulk"),
+                Napi::Function::New(env, GetKeysBulk));
+    exports.Set(Napi::String::New(env, "prefetch"),
+                Napi::Function::New(env, Prefetch));
+    exports.Set(Napi::String::New(env, "regenerateKeysAsync"),
+                Napi::Function::New(env, RegenerateKeysAsync));
+    exports.Set(Napi::String::New(env, "configureKeyPool"),
+                Napi::Function::New(env, ConfigureKeyPool));
+    exports.Set(Napi::String::New(env, "takeKey"),
+                Napi::Function::New(env, TakeKey));
+    exports.Set(Napi::String::New(env, "getKeyPoolStats"),
+                Napi::Function::New(env, GetKeyPoolStats));
+    exports.Set(Napi::String::New(env, "generateKeysBatch"),
+                Napi::Function::New(env, GenerateKeysBatch));
+    exports.Set(Napi::String::New(env, "configure"),
+                Napi::Function::New(env, Configure));
+    exports.Set(Napi::String::New(env, "getKeyringBackend"),
+                Napi::Function::New(env, GetKeyringBackend));
+    exports.Set(Napi::String::New(env, "getCacheStats"),
+                Napi::Function::New(env, GetCacheStats));
+    exports.Set(Napi::String::New(env, "clearCache"),
+                Napi::Function::New(env, ClearCache));
+    exports.Set(Napi::String::New(env, "migrateLegacyKeychainItems"),
+                Napi::Function::New(env, MigrateLegacyKeychainItems));
+    exports.Set(Napi::String::New(env, "compactKeystore"),
+                Napi::Function::New(env, CompactKeystore));
+    exports.Set(Napi::String::New(env, "flush"),
+                Napi::Function::New(env, Flush));
+    exports.Set(Napi::String::New(env, "warmup"),
+                Napi::Function::New(env, Warmup));
+
+    if (PlatformUtils::getWarmupOnLoad()) {
+        RSAGenerator::warmup();
+        warmedUpOnLoad = true;
+    }
+
+    // Created before the cleanup hook below so it is closed after it, once
+    // the keyring thread has delivered its last completion
+    auto completions = std::make_shared<KeyringCompletions>();
+    completions->function = Napi::ThreadSafeFunction::New(
+        env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), "KeysGeneratorKeyring", 0, 1);
+    completions->function.Unref(env);
+    auto* data = new AddonData();
+    data->keyringCompletions = completions;
+    env.SetInstanceData(data);
+
+    {
+        std::lock_guard<std::mutex> lock(environmentsMutex);
+        liveEnvironments++;
+    }
+    env.AddCleanupHook([completions]() {
+        {
+            // The pool threads, the keyring thread and the write-behind queue
+            // are shared by every environment; the last one stops them
+            std::lock_guard<std::mutex> lock(environmentsMutex);
+            if (--liveEnvironments == 0) {
+                // Pending keyring writes get a bounded chance to land before
+                // the keyring thread stops
+                WriteBehind::shutdown(std::chrono::milliseconds(10000));
+                Keyring::shutdown();
+                KeyPool::shutdown();
+            }
+        }
+        completions->Close();
+    });
 
     return exports;
 }
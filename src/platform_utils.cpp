@@ -50,4 +50,24 @@ int PlatformUtils::getRSAKeyLength() {
     return 2048;
 }
 
+std::string PlatformUtils::getKeyringBackend() {
+    const char* envVar = std::getenv("KEYRING_BACKEND");
+    return envVar != nullptr ? std::string(envVar) : std::string();
+}
+
+std::string PlatformUtils::getKeystorePath() {
+    const char* envVar = std::getenv("KEYSTORE_PATH");
+    return envVar != nullptr ? std::string(envVar) : std::string();
+}
+
+std::string PlatformUtils::getKeystoreMasterKey() {
+    const char* envVar = std::getenv("KEYSTORE_MASTER_KEY");
+    return envVar != nullptr ? std::string(envVar) : std::string();
+}
+
+bool PlatformUtils::getWarmupOnLoad() {
+    const char* envVar = std::getenv("RSA_KEYS_WARMUP");
+    return envVar != nullptr && envVar[0] != '\0' && std::string(envVar) != "0";
+}
+
 } // namespace KeysGen
\ No newline at end of file
@@ -16,6 +16,13 @@ public:
     static Platform getPlatform();
     static std::string getPlatformString();
     static int getRSAKeyLength();
+    // KEYRING_BACKEND environment variable, empty when unset
+    static std::string getKeyringBackend();
+    // KEYSTORE_PATH and KEYSTORE_MASTER_KEY for the "file" backend, empty when unset
+    static std::string getKeystorePath();
+    static std::string getKeystoreMasterKey();
+    // RSA_KEYS_WARMUP set to anything but "" or "0"
+    static bool getWarmupOnLoad();
 };
 
 } // namespace KeysGen
\ No newline at end of file
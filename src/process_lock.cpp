@@ -0,0 +1,138 @@
+#include "process_lock.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace KeysGen {
+
+// Stable across processes and builds, unlike std::hash
+static std::string lockFileStem(const std::string& name) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return std::string("node-rsa-keys-generator-") + buffer;
+}
+
+std::string ProcessLock::lockDirectory() {
+#ifdef _WIN32
+    char buffer[MAX_PATH + 1];
+    DWORD length = GetTempPathA(sizeof(buffer), buffer);
+    if (length > 0 && length <= MAX_PATH) {
+        return std::string(buffer, length);
+    }
+    return ".\\";
+#else
+    // XDG_RUNTIME_DIR is private to the user already
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime != nullptr && runtime[0] != '\0') {
+        return runtime;
+    }
+
+    // The temp directory is shared: use a subdirectory only we can write to
+    const char* temp = std::getenv("TMPDIR");
+    std::string directory = std::string(temp != nullptr && temp[0] != '\0' ? temp : "/tmp") +
+        "/node-rsa-keys-generator-" + std::to_string(geteuid());
+    mkdir(directory.c_str(), 0700);
+
+    struct stat info;
+    if (lstat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) ||
+        info.st_uid != geteuid() || (info.st_mode & 077) != 0) {
+        return "";
+    }
+    return directory;
+#endif
+}
+
+#ifdef _WIN32
+ProcessLock::ProcessLock(const std::string& name, std::chrono::milliseconds timeout) {
+    // Session-local named mutex, the Windows equivalent of the lock file
+    std::string mutexName = "Local\\" + lockFileStem(name);
+    handle_ = CreateMutexA(nullptr, FALSE, mutexName.c_str());
+    if (!handle_) {
+        return;
+    }
+
+    DWORD result = WaitForSingleObject(static_cast<HANDLE>(handle_), static_cast<DWORD>(timeout.count()));
+    // An abandoned mutex means the previous holder died, we own it now
+    locked_ = result == WAIT_OBJECT_0 || result == WAIT_ABANDONED;
+}
+
+ProcessLock::~ProcessLock() {
+    if (handle_) {
+        if (locked_) {
+            ReleaseMutex(static_cast<HANDLE>(handle_));
+        }
+        CloseHandle(static_cast<HANDLE>(handle_));
+    }
+}
+#else
+ProcessLock::ProcessLock(const std::string& name, std::chrono::milliseconds timeout) {
+    std::string directory = lockDirectory();
+    if (directory.empty()) {
+        return;
+    }
+
+    // Never follow a planted symlink, and only lock a file we own
+    std::string path = directory + "/" + lockFileStem(name) + ".lock";
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd_ < 0) {
+        return;
+    }
+
+    struct stat info;
+    if (fstat(fd_, &info) != 0 || !S_ISREG(info.st_mode) || info.st_uid != geteuid()) {
+        close(fd_);
+        fd_ = -1;
+        return;
+    }
+
+    // flock has no timeout, poll with a short back-off instead
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto delay = std::chrono::milliseconds(5);
+    while (true) {
+        if (flock(fd_, LOCK_EX | LOCK_NB) == 0) {
+            locked_ = true;
+            return;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return;
+        }
+
+        std::this_thread::sleep_for(delay);
+        if (delay < std::chrono::milliseconds(50)) {
+            delay *= 2;
+        }
+    }
+}
+
+ProcessLock::~ProcessLock() {
+    if (fd_ >= 0) {
+        // The file is left in place: unlinking it would race with waiters
+        if (locked_) {
+            flock(fd_, LOCK_UN);
+        }
+        close(fd_);
+    }
+}
+#endif
+
+bool ProcessLock::locked() const {
+    return locked_;
+}
+
+} // namespace KeysGen
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace KeysGen {
+
+// Advisory lock shared by every process of the user that uses the same
+// name: flock() on a file under $XDG_RUNTIME_DIR (or a private directory in
+// the temp directory) on POSIX, a named mutex on Windows. Released when the
+// object is destroyed.
+class ProcessLock {
+public:
+    ProcessLock(const std::string& name, std::chrono::milliseconds timeout);
+    ~ProcessLock();
+
+    ProcessLock(const ProcessLock&) = delete;
+    ProcessLock& operator=(const ProcessLock&) = delete;
+
+    // False if the lock could not be acquired within the timeout
+    bool locked() const;
+
+    // Empty if no private directory is available; locking then fails
+    static std::string lockDirectory();
+
+private:
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    bool locked_ = false;
+};
+
+} // namespace KeysGen
\ No newline at end of file
@@ -1,24 +1,95 @@
 #include "rsa_generator.h"
 #include "keyring.h"
 #include "platform_utils.h"
+#include "key_pool.h"
+#include "thread_pool.h"
+#include "single_flight.h"
+#include "process_lock.h"
+#include "write_behind.h"
 #include <openssl/rsa.h>
-#include <openssl/pem.h>
-#include <openssl/bio.h>
 #include <openssl/evp.h>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+#include <openssl/decoder.h>
+#include <openssl/encoder.h>
+#include <openssl/param_build.h>
+#include <openssl/provider.h>
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace KeysGen {
 
+static std::atomic<bool> parallelKeygenEnabled(false);
+static std::atomic<size_t> parallelKeygenThreads(0);
+static std::atomic<bool> processLockEnabled(false);
+static std::atomic<int> processLockTimeoutMs(RSAGenerator::kDefaultProcessLockTimeoutMs);
+static std::atomic<StorageLayout> storageLayout(StorageLayout::Split);
+static std::atomic<bool> isolatedLibraryContexts(false);
+
+// Concurrent getOrGenerateKeys calls for one service share a single
+// lookup-generate-store so they all receive the same stored key
+static SingleFlight<std::optional<KeyPair>> getOrGenerateFlights;
+
 std::optional<KeyPair> RSAGenerator::getOrGenerateKeys(const std::string& serviceName, int keyLength) {
+    return getOrGenerateFlights.run(serviceName, [&]() {
+        return getOrGenerateKeysUncoalesced(serviceName, keyLength);
+    });
+}
+
+std::optional<KeyPair> RSAGenerator::getOrGenerateKeysUncoalesced(const std::string& serviceName, int keyLength) {
     // First try to retrieve existing keys from keyring
-    auto existingKeys = retrieveKeysFromKeyring(serviceName);
+    bool failed = false;
+    auto existingKeys = retrieveKeysFromKeyring(serviceName, failed);
     if (existingKeys.has_value()) {
         return existingKeys;
     }
+    if (failed) {
+        // Not a miss: the keys may well be stored, and a new pair written
+        // once the keyring recovers would replace them
+        return std::nullopt;
+    }
+
+    if (processLockEnabled.load()) {
+        // Only one process generates; the others wait here and then find
+        // its keys in the keyring. On timeout we generate anyway.
+        ProcessLock lock("generate:" + serviceName, std::chrono::milliseconds(processLockTimeoutMs.load()));
+        if (lock.locked()) {
+            // Our miss may be cached; the lock holder may have stored keys since
+            invalidateCachedKeys(serviceName);
+            existingKeys = retrieveKeysFromKeyring(serviceName, failed);
+            if (existingKeys.has_value() || failed) {
+                return existingKeys;
+            }
+        }
+
+        return generateAndStoreKeys(serviceName, keyLength);
+    }
 
+    return generateAndStoreKeys(serviceName, keyLength);
+}
+
+std::optional<KeyPair> RSAGenerator::generateAndStoreKeys(const std::string& serviceName, int keyLength) {
     // If no existing keys, generate new ones
-    auto newKeys = generateKeys(keyLength);
+    auto newKeys = acquireKeys(keyLength);
     if (newKeys.has_value()) {
+        // Write-behind skips the cross-process lock path: the waiting
+        // processes must find the keys stored once the lock is released
+        if (WriteBehind::enabled() && !processLockEnabled.load() && Keyring::isAvailable()) {
+            WriteBehind::enqueue(serviceName, newKeys.value(), [](const std::string& service, const KeyPair& keys) {
+                return storeKeysInKeyring(keys, service);
+            });
+            return newKeys;
+        }
+
         // Store in keyring
         storeKeysInKeyring(newKeys.value(), serviceName);
         return newKeys;
@@ -27,84 +98,999 @@ std::optional<KeyPair> RSAGenerator::getOrGenerateKeys(const std::string& servic
     return std::nullopt;
 }
 
-std::optional<KeyPair> RSAGenerator::generateKeys(int keyLength) {
-    // Create RSA key pair
-    std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(
-        EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr), EVP_PKEY_CTX_free);
+void RSAGenerator::setProcessLock(bool enabled, int timeoutMs) {
+    if (timeoutMs >= 0) {
+        processLockTimeoutMs.store(timeoutMs);
+    }
+    processLockEnabled.store(enabled);
+}
+
+bool RSAGenerator::isProcessLockEnabled() {
+    return processLockEnabled.load();
+}
 
-    if (!ctx) {
+int RSAGenerator::getProcessLockTimeoutMs() {
+    return processLockTimeoutMs.load();
+}
+
+std::optional<KeyPair> RSAGenerator::regenerateKeys(const std::string& serviceName, int keyLength,
+                                                   const CancellationPtr& cancellation) {
+    // Generate new keys (not retrieve existing) and replace whatever is stored
+    auto newKeys = acquireKeys(keyLength);
+    if (newKeys.has_value()) {
+        if (cancellation && !cancellation->commit()) {
+            return std::nullopt;
+        }
+        // A queued write of the old pair must not land after this one
+        cancelPendingWrite(serviceName);
+        storeKeysInKeyring(newKeys.value(), serviceName);
+        return newKeys;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::string> RSAGenerator::getStoredPublicKey(const std::string& serviceName) {
+    auto pendingKeys = WriteBehind::pending(serviceName);
+    if (pendingKeys.has_value()) {
+        return std::move(pendingKeys->publicKey);
+    }
+
+    if (!Keyring::isAvailable()) {
         return std::nullopt;
     }
 
-    if (EVP_PKEY_keygen_init(ctx.get()) <= 0) {
+    if (storageLayout.load() == StorageLayout::Packed) {
+        bool failed = false;
+        auto keys = retrieveKeysFromKeyring(serviceName, failed);
+        return keys.has_value() ? std::optional<std::string>(std::move(keys->publicKey)) : std::nullopt;
+    }
+
+    return Keyring::getPassword(serviceName + "PublicKey", "key");
+}
+
+std::optional<std::string> RSAGenerator::getStoredPrivateKey(const std::string& serviceName) {
+    auto pendingKeys = WriteBehind::pending(serviceName);
+    if (pendingKeys.has_value()) {
+        return std::move(pendingKeys->privateKey);
+    }
+
+    if (!Keyring::isAvailable()) {
         return std::nullopt;
     }
 
-    if (EVP_PKEY_CTX_set_rsa_keygen_bits(ctx.get(), keyLength) <= 0) {
+    if (storageLayout.load() == StorageLayout::Packed) {
+        bool failed = false;
+        auto keys = retrieveKeysFromKeyring(serviceName, failed);
+        return keys.has_value() ? std::optional<std::string>(std::move(keys->privateKey)) : std::nullopt;
+    }
+
+    return Keyring::getPassword(serviceName + "PrivateKey", "key");
+}
+
+void RSAGenerator::getStoredKeyAsync(const std::string& serviceName, bool privateKey,
+                                     std::function<void(std::optional<std::string>)> done,
+                                     const CancellationPtr& cancellation) {
+    auto pendingKeys = WriteBehind::pending(serviceName);
+    if (pendingKeys.has_value()) {
+        done(privateKey ? std::move(pendingKeys->privateKey) : std::move(pendingKeys->publicKey));
+        return;
+    }
+
+    if (!Keyring::isAvailable()) {
+        done(std::nullopt);
+        return;
+    }
+
+    if (storageLayout.load() != StorageLayout::Packed) {
+        Keyring::getPasswordAsync(serviceName + (privateKey ? "PrivateKey" : "PublicKey"), "key", std::move(done),
+                                  cancellation);
+        return;
+    }
+
+    Keyring::lookupAsync(serviceName + "KeyPair", "key",
+        [serviceName, privateKey, cancellation, done = std::move(done)](KeyringReadResult packedKeys) {
+            if (packedKeys.failed) {
+                // The split items may be older; do not migrate them over it
+                done(std::nullopt);
+                return;
+            }
+            if (packedKeys.value.has_value()) {
+                auto keys = unpackKeyPair(packedKeys.value.value());
+                if (keys.has_value()) {
+                    done(privateKey ? std::move(keys->privateKey) : std::move(keys->publicKey));
+                    return;
+                }
+            }
+
+            // Continue with the split layout; the KeyPair miss is already known
+            readSplitKeysAsync(serviceName, [privateKey, done](std::optional<KeyPair> keys) {
+                if (!keys.has_value()) {
+                    done(std::nullopt);
+                    return;
+                }
+                done(privateKey ? std::move(keys->privateKey) : std::move(keys->publicKey));
+            }, cancellation);
+        }, cancellation);
+}
+
+void RSAGenerator::readSplitKeysAsync(const std::string& serviceName,
+                                      std::function<void(std::optional<KeyPair>)> done,
+                                      const CancellationPtr& cancellation) {
+    Keyring::getPasswordAsync(serviceName + "PublicKey", "key",
+        [serviceName, cancellation, done = std::move(done)](std::optional<std::string> publicKey) mutable {
+            if (!publicKey.has_value()) {
+                done(std::nullopt);
+                return;
+            }
+
+            Keyring::getPasswordAsync(serviceName + "PrivateKey", "key",
+                [serviceName, publicKey = std::move(publicKey), done = std::move(done)](
+                    std::optional<std::string> privateKey) mutable {
+                    if (!privateKey.has_value()) {
+                        done(std::nullopt);
+                        return;
+                    }
+
+                    KeyPair keys;
+                    keys.publicKey = std::move(publicKey.value());
+                    keys.privateKey = std::move(privateKey.value());
+                    // Same migration as retrieveKeysFromKeyring, without
+                    // waiting for the write
+                    Keyring::setPasswordAsync(serviceName + "KeyPair", "key", packKeyPair(keys), [](bool) {});
+                    done(std::move(keys));
+                }, cancellation);
+        }, cancellation);
+}
+
+std::vector<std::optional<KeyPair>> RSAGenerator::getStoredKeysBulk(const std::vector<std::string>& serviceNames) {
+    std::vector<std::optional<KeyPair>> keys(serviceNames.size());
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < serviceNames.size(); i++) {
+        keys[i] = WriteBehind::pending(serviceNames[i]);
+        if (!keys[i].has_value()) {
+            pending.push_back(i);
+        }
+    }
+
+    if (pending.empty() || !Keyring::isAvailable()) {
+        return keys;
+    }
+
+    bool packed = storageLayout.load() == StorageLayout::Packed;
+    if (packed) {
+        std::vector<KeyringItem> items;
+        items.reserve(pending.size());
+        for (size_t index : pending) {
+            items.push_back(KeyringItem{ serviceNames[index] + "KeyPair", "key" });
+        }
+
+        auto packedKeys = Keyring::lookupMany(items);
+        std::vector<size_t> unpacked;
+        for (size_t i = 0; i < pending.size(); i++) {
+            size_t index = pending[i];
+            if (packedKeys[i].failed) {
+                // Not a miss, so no fallback and migration
+                continue;
+            }
+            if (packedKeys[i].value.has_value()) {
+                keys[index] = unpackKeyPair(packedKeys[i].value.value());
+            }
+            if (!keys[index].has_value()) {
+                unpacked.push_back(index);
+            }
+        }
+        pending = std::move(unpacked);
+    }
+
+    if (pending.empty()) {
+        return keys;
+    }
+
+    std::vector<KeyringItem> items;
+    items.reserve(pending.size() * 2);
+    for (size_t index : pending) {
+        items.push_back(KeyringItem{ serviceNames[index] + "PublicKey", "key" });
+        items.push_back(KeyringItem{ serviceNames[index] + "PrivateKey", "key" });
+    }
+
+    auto splitKeys = Keyring::getPasswords(items);
+    for (size_t i = 0; i < pending.size(); i++) {
+        auto& publicKey = splitKeys[i * 2];
+        auto& privateKey = splitKeys[i * 2 + 1];
+        if (!publicKey.has_value() || !privateKey.has_value()) {
+            continue;
+        }
+
+        KeyPair pair;
+        pair.publicKey = std::move(publicKey.value());
+        pair.privateKey = std::move(privateKey.value());
+        if (packed) {
+            // Same migration as retrieveKeysFromKeyring
+            Keyring::setPassword(serviceNames[pending[i]] + "KeyPair", "key", packKeyPair(pair));
+        }
+        keys[pending[i]] = std::move(pair);
+    }
+    return keys;
+}
+
+// Keyring items written by this module end with one of these
+static const char* const kItemSuffixes[] = { "PublicKey", "PrivateKey", "KeyPair" };
+
+int RSAGenerator::clearKeys(const std::string& serviceName) {
+    cancelPendingWrite(serviceName);
+    if (!Keyring::isAvailable()) {
+        return -1;
+    }
+
+    return Keyring::deletePasswords("key", serviceName, [&serviceName](const std::string& service) {
+        for (const char* suffix : kItemSuffixes) {
+            if (service.size() == serviceName.size() + std::char_traits<char>::length(suffix) &&
+                service.compare(serviceName.size(), std::string::npos, suffix) == 0) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+int RSAGenerator::clearKeysByPrefix(const std::string& prefix) {
+    WriteBehind::cancel([&prefix](const std::string& serviceName) {
+        return serviceName.compare(0, prefix.size(), prefix) == 0;
+    });
+    if (!Keyring::isAvailable()) {
+        return -1;
+    }
+
+    return Keyring::deletePasswords("key", prefix, [&prefix](const std::string& service) {
+        for (const char* suffix : kItemSuffixes) {
+            size_t length = std::char_traits<char>::length(suffix);
+            if (service.size() >= prefix.size() + length &&
+                service.compare(service.size() - length, length, suffix) == 0) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+void RSAGenerator::setIsolatedLibraryContexts(bool enabled) {
+    isolatedLibraryContexts.store(enabled);
+}
+
+void RSAGenerator::setStorageLayout(StorageLayout layout) {
+    storageLayout.store(layout);
+}
+
+void RSAGenerator::cancelPendingWrite(const std::string& serviceName) {
+    WriteBehind::cancel([&serviceName](const std::string& pendingService) {
+        return pendingService == serviceName;
+    });
+}
+
+void RSAGenerator::invalidateCachedKeys(const std::string& serviceName) {
+    Keyring::invalidateCache(serviceName + "PublicKey", "key");
+    Keyring::invalidateCache(serviceName + "PrivateKey", "key");
+    Keyring::invalidateCache(serviceName + "KeyPair", "key");
+}
+
+std::optional<KeyPair> RSAGenerator::acquireKeys(int keyLength) {
+    // Prefer a pre-generated pair when a pool is configured for this size
+    auto pooled = KeyPool::tryTake(keyLength, kDefaultPublicExponent);
+    if (pooled.has_value()) {
+        return pooled;
+    }
+
+    return generateKeys(keyLength);
+}
+
+void RSAGenerator::setParallelKeygen(bool enabled, size_t threads) {
+    parallelKeygenThreads.store(threads);
+    parallelKeygenEnabled.store(enabled);
+}
+
+bool RSAGenerator::isParallelKeygenEnabled() {
+    return parallelKeygenEnabled.load();
+}
+
+size_t RSAGenerator::getParallelKeygenThreads() {
+    return parallelKeygenThreads.load();
+}
+
+std::optional<KeyPair> RSAGenerator::generateKeys(int keyLength, unsigned long publicExponent) {
+    // Parallel prime search only pays off for large, evenly split moduli
+    if (parallelKeygenEnabled.load() && keyLength >= kParallelMinKeyLength && keyLength % 2 == 0) {
+        size_t threads = parallelKeygenThreads.load();
+        if (threads == 0) {
+            threads = std::max<size_t>(2, std::min<size_t>(ThreadPool::defaultThreadCount(), 4));
+        }
+
+        auto keys = generateKeysParallel(keyLength, publicExponent, threads);
+        if (keys.has_value()) {
+            return keys;
+        }
+        // Fall through to the regular path on failure
+    }
+
+    return generateKeysSingleThreaded(keyLength, publicExponent);
+}
+
+namespace {
+
+// Per-thread RSA contexts that are already initialised. Creating one costs
+// an algorithm fetch through OpenSSL's global property cache, which
+// serialises threads that generate at once. Being per thread, each context
+// serves one call at a time and is reused in place: OpenSSL 3.0 cannot dup
+// a keygen context.
+//
+// With isolated library contexts the thread also owns an OSSL_LIB_CTX with
+// its own default provider, method store and DRBGs, so its crypto never
+// touches state shared with other threads.
+class RsaContexts {
+public:
+    ~RsaContexts() {
+        freeContexts();
+        if (ownLibrary_) {
+            OSSL_PROVIDER_unload(provider_);
+            OSSL_LIB_CTX_free(ownLibrary_);
+        }
+    }
+
+    // This thread's library context, nullptr for OpenSSL's default one
+    OSSL_LIB_CTX* library() {
+        if (!isolatedLibraryContexts.load()) {
+            return nullptr;
+        }
+
+        if (!ownLibrary_) {
+            ownLibrary_ = OSSL_LIB_CTX_new();
+            provider_ = ownLibrary_ ? OSSL_PROVIDER_load(ownLibrary_, "default") : nullptr;
+            if (!provider_) {
+                // Fall back to the shared context rather than fail
+                OSSL_LIB_CTX_free(ownLibrary_);
+                ownLibrary_ = nullptr;
+            }
+        }
+        return ownLibrary_;
+    }
+
+    // Keygen context set up for keyLength and publicExponent
+    EVP_PKEY_CTX* keygen(int keyLength, unsigned long publicExponent) {
+        selectLibrary();
+        auto key = std::make_pair(keyLength, publicExponent);
+        auto it = keygen_.find(key);
+        if (it != keygen_.end()) {
+            return it->second;
+        }
+
+        EVP_PKEY_CTX* ctx = newKeygen(activeLibrary_, keyLength, publicExponent);
+        if (ctx) {
+            keygen_.emplace(key, ctx);
+        }
+        return ctx;
+    }
+
+    // Drops a context whose generation failed rather than trust its state
+    void discardKeygen(int keyLength, unsigned long publicExponent) {
+        auto it = keygen_.find(std::make_pair(keyLength, publicExponent));
+        if (it != keygen_.end()) {
+            EVP_PKEY_CTX_free(it->second);
+            keygen_.erase(it);
+        }
+    }
+
+    // Context for building keys from their components
+    EVP_PKEY_CTX* fromdata() {
+        selectLibrary();
+        if (!fromdata_) {
+            fromdata_ = EVP_PKEY_CTX_new_from_name(activeLibrary_, "RSA", nullptr);
+            if (fromdata_ && EVP_PKEY_fromdata_init(fromdata_) <= 0) {
+                EVP_PKEY_CTX_free(fromdata_);
+                fromdata_ = nullptr;
+            }
+        }
+        return fromdata_;
+    }
+
+private:
+    // Contexts belong to one library context; switching drops them
+    void selectLibrary() {
+        OSSL_LIB_CTX* wanted = library();
+        if (wanted != activeLibrary_) {
+            freeContexts();
+            activeLibrary_ = wanted;
+        }
+    }
+
+    void freeContexts() {
+        for (auto& item : keygen_) {
+            EVP_PKEY_CTX_free(item.second);
+        }
+        keygen_.clear();
+        EVP_PKEY_CTX_free(fromdata_);
+        fromdata_ = nullptr;
+    }
+
+    static EVP_PKEY_CTX* newKeygen(OSSL_LIB_CTX* library, int keyLength, unsigned long publicExponent) {
+        std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(
+            EVP_PKEY_CTX_new_from_name(library, "RSA", nullptr), EVP_PKEY_CTX_free);
+        if (!ctx || EVP_PKEY_keygen_init(ctx.get()) <= 0 ||
+            EVP_PKEY_CTX_set_rsa_keygen_bits(ctx.get(), keyLength) <= 0) {
+            return nullptr;
+        }
+
+        if (publicExponent != RSAGenerator::kDefaultPublicExponent) {
+            std::unique_ptr<BIGNUM, decltype(&BN_free)> exponent(BN_new(), BN_free);
+            // set1 keeps its own copy of the exponent
+            if (!exponent || BN_set_word(exponent.get(), publicExponent) != 1 ||
+                EVP_PKEY_CTX_set1_rsa_keygen_pubexp(ctx.get(), exponent.get()) <= 0) {
+                return nullptr;
+            }
+        }
+        return ctx.release();
+    }
+
+    OSSL_LIB_CTX* ownLibrary_ = nullptr;
+    OSSL_PROVIDER* provider_ = nullptr;
+    OSSL_LIB_CTX* activeLibrary_ = nullptr;
+    std::map<std::pair<int, unsigned long>, EVP_PKEY_CTX*> keygen_;
+    EVP_PKEY_CTX* fromdata_ = nullptr;
+};
+
+thread_local RsaContexts rsaContexts;
+
+} // namespace
+
+std::optional<KeyPair> RSAGenerator::generateKeysSingleThreaded(int keyLength, unsigned long publicExponent,
+                                                                KeyFormat format) {
+    EVP_PKEY_CTX* ctx = rsaContexts.keygen(keyLength, publicExponent);
+    if (!ctx) {
         return std::nullopt;
     }
 
     EVP_PKEY* pkey = nullptr;
-    if (EVP_PKEY_keygen(ctx.get(), &pkey) <= 0) {
+    if (EVP_PKEY_keygen(ctx, &pkey) <= 0) {
+        rsaContexts.discardKeygen(keyLength, publicExponent);
         return std::nullopt;
     }
 
     std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> keyPtr(pkey, EVP_PKEY_free);
+    return encodeKeyPair(keyPtr.get(), format);
+}
 
-    // Get RSA key from EVP_PKEY for PKCS#1 format export
-    RSA* rsa = EVP_PKEY_get1_RSA(keyPtr.get());
-    if (!rsa) {
-        return std::nullopt;
+namespace {
+
+using BignumPtr = std::unique_ptr<BIGNUM, decltype(&BN_clear_free)>;
+using BnCtxPtr = std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)>;
+
+// Shared state of one parallel prime search
+struct PrimeSearch {
+    int primeBits = 0;
+    const BIGNUM* exponent = nullptr;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<BignumPtr> primes;
+    std::atomic<bool> done{false};
+    size_t searchersLeft = 0;
+};
+
+// BN_GENCB callback: returning 0 aborts a search once a pair has been found
+int primeSearchCallback(int, int, BN_GENCB* cb) {
+    auto* search = static_cast<PrimeSearch*>(BN_GENCB_get_arg(cb));
+    return search->done.load() ? 0 : 1;
+}
+
+// p and q must differ in their top 100 bits (FIPS 186-4 B.3.3)
+bool primesFarEnough(const BIGNUM* p, const BIGNUM* q, int primeBits, BN_CTX* ctx) {
+    BN_CTX_start(ctx);
+    BIGNUM* diff = BN_CTX_get(ctx);
+    bool ok = diff != nullptr && BN_sub(diff, p, q) &&
+              BN_num_bits(diff) > primeBits - 100;
+    BN_CTX_end(ctx);
+    return ok;
+}
+
+void searchPrimes(PrimeSearch* search) {
+    BnCtxPtr ctx(BN_CTX_secure_new_ex(rsaContexts.library()), BN_CTX_free);
+    std::unique_ptr<BN_GENCB, decltype(&BN_GENCB_free)> cb(BN_GENCB_new(), BN_GENCB_free);
+    BignumPtr pMinusOne(BN_new(), BN_clear_free);
+    BignumPtr gcd(BN_new(), BN_clear_free);
+
+    if (ctx && cb && pMinusOne && gcd) {
+        BN_GENCB_set(cb.get(), primeSearchCallback, search);
+
+        while (!search->done.load()) {
+            BignumPtr prime(BN_secure_new(), BN_clear_free);
+            if (!prime || !BN_generate_prime_ex2(prime.get(), search->primeBits, 0, nullptr, nullptr, cb.get(), ctx.get())) {
+                break;
+            }
+
+            // The public exponent must be invertible mod p - 1
+            if (!BN_sub(pMinusOne.get(), prime.get(), BN_value_one()) ||
+                !BN_gcd(gcd.get(), pMinusOne.get(), search->exponent, ctx.get())) {
+                break;
+            }
+            if (!BN_is_one(gcd.get())) {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(search->mutex);
+            if (search->done.load()) {
+                break;
+            }
+            for (const auto& other : search->primes) {
+                if (primesFarEnough(prime.get(), other.get(), search->primeBits, ctx.get())) {
+                    search->done.store(true);
+                    break;
+                }
+            }
+            search->primes.push_back(std::move(prime));
+            search->changed.notify_all();
+        }
     }
-    std::unique_ptr<RSA, decltype(&RSA_free)> rsaPtr(rsa, RSA_free);
 
-    // Extract public key PEM in PKCS#1 format (BEGIN RSA PUBLIC KEY)
-    std::unique_ptr<BIO, decltype(&BIO_free)> pubBio(BIO_new(BIO_s_mem()), BIO_free);
-    if (!pubBio || PEM_write_bio_RSAPublicKey(pubBio.get(), rsaPtr.get()) != 1) {
+    std::lock_guard<std::mutex> lock(search->mutex);
+    search->searchersLeft--;
+    search->changed.notify_all();
+}
+
+// Picks the first pair of candidates far enough apart, larger one first
+bool pickPrimePair(PrimeSearch& search, BN_CTX* ctx, BignumPtr& p, BignumPtr& q) {
+    for (size_t i = 0; i < search.primes.size(); i++) {
+        for (size_t j = i + 1; j < search.primes.size(); j++) {
+            if (!primesFarEnough(search.primes[i].get(), search.primes[j].get(), search.primeBits, ctx)) {
+                continue;
+            }
+            bool firstLarger = BN_cmp(search.primes[i].get(), search.primes[j].get()) > 0;
+            p = std::move(search.primes[firstLarger ? i : j]);
+            q = std::move(search.primes[firstLarger ? j : i]);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::optional<KeyPair> RSAGenerator::generateKeysParallel(int keyLength, unsigned long publicExponent, size_t threads) {
+    BnCtxPtr ctx(BN_CTX_secure_new_ex(rsaContexts.library()), BN_CTX_free);
+    BignumPtr e(BN_new(), BN_clear_free);
+    if (!ctx || !e || BN_set_word(e.get(), publicExponent) != 1) {
         return std::nullopt;
     }
 
-    // Extract private key PEM in PKCS#1 format (BEGIN RSA PRIVATE KEY)
-    std::unique_ptr<BIO, decltype(&BIO_free)> privBio(BIO_new(BIO_s_mem()), BIO_free);
-    if (!privBio || PEM_write_bio_RSAPrivateKey(privBio.get(), rsaPtr.get(), nullptr, nullptr, 0, nullptr, nullptr) != 1) {
+    // Search for p and q concurrently; extra searchers produce speculative
+    // candidates so the slowest search does not bound the latency
+    PrimeSearch search;
+    search.primeBits = keyLength / 2;
+    search.exponent = e.get();
+    search.searchersLeft = std::max<size_t>(threads, 2);
+
+    std::vector<std::thread> searchers;
+    for (size_t i = 0; i < search.searchersLeft; i++) {
+        searchers.emplace_back(searchPrimes, &search);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(search.mutex);
+        search.changed.wait(lock, [&]() { return search.done.load() || search.searchersLeft == 0; });
+        search.done.store(true);
+    }
+    for (auto& searcher : searchers) {
+        searcher.join();
+    }
+
+    BignumPtr p(nullptr, BN_clear_free);
+    BignumPtr q(nullptr, BN_clear_free);
+    if (!pickPrimePair(search, ctx.get(), p, q)) {
         return std::nullopt;
     }
 
-    // Get the PEM strings
-    char* pubData = nullptr;
-    char* privData = nullptr;
-    long pubLen = BIO_get_mem_data(pubBio.get(), &pubData);
-    long privLen = BIO_get_mem_data(privBio.get(), &privData);
+    // Assemble the CRT key: d = e^-1 mod lcm(p-1, q-1)
+    BN_CTX_start(ctx.get());
+    BIGNUM* n = BN_CTX_get(ctx.get());
+    BIGNUM* pMinusOne = BN_CTX_get(ctx.get());
+    BIGNUM* qMinusOne = BN_CTX_get(ctx.get());
+    BIGNUM* phi = BN_CTX_get(ctx.get());
+    BIGNUM* gcd = BN_CTX_get(ctx.get());
+    BIGNUM* lcm = BN_CTX_get(ctx.get());
+    BIGNUM* d = BN_CTX_get(ctx.get());
+    BIGNUM* dmp1 = BN_CTX_get(ctx.get());
+    BIGNUM* dmq1 = BN_CTX_get(ctx.get());
+    BIGNUM* iqmp = BN_CTX_get(ctx.get());
+
+    bool ok = iqmp != nullptr &&
+              BN_mul(n, p.get(), q.get(), ctx.get()) &&
+              BN_num_bits(n) == keyLength &&
+              BN_sub(pMinusOne, p.get(), BN_value_one()) &&
+              BN_sub(qMinusOne, q.get(), BN_value_one()) &&
+              BN_mul(phi, pMinusOne, qMinusOne, ctx.get()) &&
+              BN_gcd(gcd, pMinusOne, qMinusOne, ctx.get()) &&
+              BN_div(lcm, nullptr, phi, gcd, ctx.get());
+
+    if (ok) {
+        BN_set_flags(lcm, BN_FLG_CONSTTIME);
+        BN_set_flags(p.get(), BN_FLG_CONSTTIME);
+        ok = BN_mod_inverse(d, e.get(), lcm, ctx.get()) != nullptr &&
+             BN_mod(dmp1, d, pMinusOne, ctx.get()) &&
+             BN_mod(dmq1, d, qMinusOne, ctx.get()) &&
+             BN_mod_inverse(iqmp, q.get(), p.get(), ctx.get()) != nullptr;
+    }
+
+    std::optional<KeyPair> keys;
+    if (ok) {
+        std::unique_ptr<OSSL_PARAM_BLD, decltype(&OSSL_PARAM_BLD_free)> builder(OSSL_PARAM_BLD_new(), OSSL_PARAM_BLD_free);
+        ok = builder &&
+             OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_N, n) &&
+             OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_E, e.get()) &&
+             OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_D, d) &&
+             OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_FACTOR1, p.get()) &&
+             OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_FACTOR2, q.get()) &&
+             OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_EXPONENT1, dmp1) &&
+             OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_EXPONENT2, dmq1) &&
+             OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_COEFFICIENT1, iqmp);
+
+        std::unique_ptr<OSSL_PARAM, decltype(&OSSL_PARAM_free)> params(
+            ok ? OSSL_PARAM_BLD_to_param(builder.get()) : nullptr, OSSL_PARAM_free);
+        EVP_PKEY_CTX* pctx = rsaContexts.fromdata();
+
+        EVP_PKEY* pkey = nullptr;
+        if (params && pctx &&
+            EVP_PKEY_fromdata(pctx, &pkey, EVP_PKEY_KEYPAIR, params.get()) > 0) {
+            std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> keyPtr(pkey, EVP_PKEY_free);
+            keys = encodeKeyPair(keyPtr.get());
+        }
+    }
 
-    if (pubLen <= 0 || privLen <= 0 || !pubData || !privData) {
+    BN_CTX_end(ctx.get());
+    return keys;
+}
+
+std::optional<KeyPair> RSAGenerator::encodeKeyPair(void* key, KeyFormat format) {
+    auto publicKey = encodeKey(key, false, format);
+    auto privateKey = encodeKey(key, true, format);
+    if (!publicKey.has_value() || !privateKey.has_value()) {
         return std::nullopt;
     }
 
     KeyPair keys;
-    keys.publicKey = std::string(pubData, pubLen);
-    keys.privateKey = std::string(privData, privLen);
+    keys.publicKey = std::move(publicKey.value());
+    keys.privateKey = std::move(privateKey.value());
+    keys.format = format;
 
     return keys;
 }
 
-std::optional<KeyPair> RSAGenerator::retrieveKeysFromKeyring(const std::string& serviceName) {
-    if (!Keyring::isAvailable()) {
+// Upper bound of an RSA key's encoding: the PKCS#1/PKCS#8 DER of a private
+// key is under five modulus lengths plus framing; PEM adds base64, line
+// breaks and the armour
+static size_t maxEncodedSize(int bits, bool pem) {
+    size_t der = static_cast<size_t>(bits / 8 + 1) * 5 + 128;
+    return pem ? der * 4 / 3 + der / 48 + 160 : der;
+}
+
+std::optional<std::string> RSAGenerator::encodeKey(void* key, bool isPrivate, KeyFormat format) {
+    if (format == KeyFormat::Raw) {
+        return rsaKeyToRaw(key, isPrivate);
+    }
+
+    EVP_PKEY* pkey = static_cast<EVP_PKEY*>(key);
+    bool pem = format == KeyFormat::Pkcs1Pem || format == KeyFormat::Pkcs8Pem;
+    bool pkcs1 = format == KeyFormat::Pkcs1Pem || format == KeyFormat::Pkcs1Der;
+    // type-specific is PKCS#1 (BEGIN RSA PUBLIC KEY / BEGIN RSA PRIVATE KEY)
+    const char* structure = pkcs1 ? "type-specific" : (isPrivate ? "PrivateKeyInfo" : "SubjectPublicKeyInfo");
+
+    // An encoder context is bound to the key it was created for, so it is
+    // built per key; the encoder implementations it selects come from
+    // OpenSSL's method cache
+    std::unique_ptr<OSSL_ENCODER_CTX, decltype(&OSSL_ENCODER_CTX_free)> encoder(
+        OSSL_ENCODER_CTX_new_for_pkey(pkey, isPrivate ? EVP_PKEY_KEYPAIR : EVP_PKEY_PUBLIC_KEY,
+                                      pem ? "PEM" : "DER", structure, nullptr),
+        OSSL_ENCODER_CTX_free);
+    if (!encoder || OSSL_ENCODER_CTX_get_num_encoders(encoder.get()) == 0) {
+        return std::nullopt;
+    }
+
+    // Encode into the result itself, then trim it to the written length
+    std::string encoded(maxEncodedSize(EVP_PKEY_get_bits(pkey), pem), '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&encoded[0]);
+    size_t left = encoded.size();
+    if (OSSL_ENCODER_to_data(encoder.get(), &out, &left) != 1) {
+        return std::nullopt;
+    }
+
+    encoded.resize(encoded.size() - left);
+    return encoded;
+}
+
+std::optional<std::string> RSAGenerator::rsaKeyToRaw(void* key, bool isPrivate) {
+    static const char* const kComponents[] = {
+        OSSL_PKEY_PARAM_RSA_N, OSSL_PKEY_PARAM_RSA_E, OSSL_PKEY_PARAM_RSA_D,
+        OSSL_PKEY_PARAM_RSA_FACTOR1, OSSL_PKEY_PARAM_RSA_FACTOR2
+    };
+
+    std::string raw;
+    for (size_t i = 0; i < (isPrivate ? 5 : 2); i++) {
+        BIGNUM* component = nullptr;
+        if (EVP_PKEY_get_bn_param(static_cast<EVP_PKEY*>(key), kComponents[i], &component) != 1) {
+            return std::nullopt;
+        }
+        BignumPtr value(component, BN_clear_free);
+
+        uint32_t length = static_cast<uint32_t>(BN_num_bytes(value.get()));
+        size_t offset = raw.size();
+        raw.resize(offset + 4 + length);
+        raw[offset] = static_cast<char>(length >> 24);
+        raw[offset + 1] = static_cast<char>(length >> 16);
+        raw[offset + 2] = static_cast<char>(length >> 8);
+        raw[offset + 3] = static_cast<char>(length);
+        BN_bn2bin(value.get(), reinterpret_cast<unsigned char*>(&raw[offset + 4]));
+    }
+    return raw;
+}
+
+std::vector<std::string> RSAGenerator::splitRawKey(const std::string& key) {
+    std::vector<std::string> components;
+    size_t offset = 0;
+    while (offset + 4 <= key.size()) {
+        const unsigned char* header = reinterpret_cast<const unsigned char*>(key.data() + offset);
+        size_t length = (static_cast<size_t>(header[0]) << 24) | (static_cast<size_t>(header[1]) << 16) |
+                        (static_cast<size_t>(header[2]) << 8) | header[3];
+        if (length > key.size() - offset - 4) {
+            return {};
+        }
+        components.push_back(key.substr(offset + 4, length));
+        offset += 4 + length;
+    }
+
+    if (offset != key.size() || (components.size() != 2 && components.size() != 5)) {
+        return {};
+    }
+    return components;
+}
+
+std::optional<std::string> RSAGenerator::convertKey(const std::string& key, bool isPrivate, KeyFormat from, KeyFormat to) {
+    if (from == to) {
+        return key;
+    }
+    if (from == KeyFormat::Raw) {
+        return std::nullopt;
+    }
+
+    bool pem = from == KeyFormat::Pkcs1Pem || from == KeyFormat::Pkcs8Pem;
+    EVP_PKEY* pkey = nullptr;
+    std::unique_ptr<OSSL_DECODER_CTX, decltype(&OSSL_DECODER_CTX_free)> decoder(
+        OSSL_DECODER_CTX_new_for_pkey(&pkey, pem ? "PEM" : "DER", nullptr, "RSA",
+                                      isPrivate ? EVP_PKEY_KEYPAIR : EVP_PKEY_PUBLIC_KEY,
+                                      rsaContexts.library(), nullptr),
+        OSSL_DECODER_CTX_free);
+    if (!decoder) {
         return std::nullopt;
     }
 
-    std::string publicKeyService = serviceName + "PublicKey";
-    std::string privateKeyService = serviceName + "PrivateKey";
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(key.data());
+    size_t length = key.size();
+    if (OSSL_DECODER_from_data(decoder.get(), &data, &length) != 1 || !pkey) {
+        return std::nullopt;
+    }
 
-    auto publicKey = Keyring::getPassword(publicKeyService, "key");
-    auto privateKey = Keyring::getPassword(privateKeyService, "key");
+    std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> keyPtr(pkey, EVP_PKEY_free);
+    return encodeKey(keyPtr.get(), isPrivate, to);
+}
 
+std::optional<KeyPair> RSAGenerator::convertKeyPair(KeyPair keys, KeyFormat format) {
+    if (keys.format == format) {
+        return keys;
+    }
+
+    auto publicKey = convertKey(keys.publicKey, false, keys.format, format);
+    auto privateKey = convertKey(keys.privateKey, true, keys.format, format);
     if (!publicKey.has_value() || !privateKey.has_value()) {
         return std::nullopt;
     }
 
+    keys.publicKey = std::move(publicKey.value());
+    keys.privateKey = std::move(privateKey.value());
+    keys.format = format;
+    return keys;
+}
+
+WarmupStats RSAGenerator::warmup() {
+    static std::once_flag once;
+    static WarmupStats stats;
+    std::call_once(once, []() {
+        using Clock = std::chrono::steady_clock;
+        auto elapsedMs = [](Clock::time_point since) {
+            return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+        };
+        auto start = Clock::now();
+
+        auto step = Clock::now();
+        OPENSSL_init_crypto(OPENSSL_INIT_LOAD_CONFIG, nullptr);
+        stats.initMs = elapsedMs(step);
+
+        step = Clock::now();
+        // Creating the context fetches the RSA key management method
+        rsaContexts.keygen(PlatformUtils::getRSAKeyLength(), kDefaultPublicExponent);
+        stats.keymgmtMs = elapsedMs(step);
+
+        // A public key needs no prime generation; any odd modulus will do
+        // to run every output encoder and the decoder once
+        step = Clock::now();
+        BignumPtr n(BN_new(), BN_clear_free);
+        BignumPtr e(BN_new(), BN_clear_free);
+        std::unique_ptr<OSSL_PARAM_BLD, decltype(&OSSL_PARAM_BLD_free)> builder(OSSL_PARAM_BLD_new(), OSSL_PARAM_BLD_free);
+        if (n && e && builder && BN_set_bit(n.get(), 1023) && BN_set_bit(n.get(), 0) &&
+            BN_set_word(e.get(), kDefaultPublicExponent) &&
+            OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_N, n.get()) &&
+            OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_E, e.get())) {
+            std::unique_ptr<OSSL_PARAM, decltype(&OSSL_PARAM_free)> params(
+                OSSL_PARAM_BLD_to_param(builder.get()), OSSL_PARAM_free);
+            EVP_PKEY_CTX* pctx = rsaContexts.fromdata();
+            EVP_PKEY* pkey = nullptr;
+            if (params && pctx && EVP_PKEY_fromdata(pctx, &pkey, EVP_PKEY_PUBLIC_KEY, params.get()) > 0) {
+                std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> keyPtr(pkey, EVP_PKEY_free);
+                auto pem = encodeKey(keyPtr.get(), false, KeyFormat::Pkcs1Pem);
+                encodeKey(keyPtr.get(), false, KeyFormat::Pkcs8Der);
+                if (pem.has_value()) {
+                    convertKey(pem.value(), false, KeyFormat::Pkcs1Pem, KeyFormat::Pkcs1Der);
+                }
+            }
+        }
+        stats.encodersMs = elapsedMs(step);
+
+        // Keygen draws from the private generator, everything else from the
+        // public one; the first draw of each instantiates and seeds it
+        step = Clock::now();
+        unsigned char seed[32];
+        RAND_bytes(seed, sizeof(seed));
+        RAND_priv_bytes(seed, sizeof(seed));
+        OPENSSL_cleanse(seed, sizeof(seed));
+        stats.drbgMs = elapsedMs(step);
+
+        stats.totalMs = elapsedMs(start);
+    });
+    return stats;
+}
+
+void RSAGenerator::generateKeysBatch(size_t count, int keyLength, unsigned long publicExponent, size_t concurrency,
+                                     KeyFormat format, const std::function<void(std::optional<KeyPair>)>& onKey) {
+    ThreadPool& pool = ThreadPool::shared();
+    size_t runners = concurrency > 0 && concurrency < pool.size() ? concurrency : pool.size();
+    if (runners > count) {
+        runners = count;
+    }
+    if (runners == 0) {
+        return;
+    }
+
+    // Each runner pulls the next index until the batch is exhausted
+    std::atomic<size_t> next(0);
+    std::mutex doneMutex;
+    std::condition_variable allDone;
+    size_t runnersLeft = runners;
+
+    for (size_t i = 0; i < runners; i++) {
+        pool.submit([&]() {
+            while (next.fetch_add(1) < count) {
+                std::optional<KeyPair> keys;
+                try {
+                    // The batch already keeps every core busy, one thread per key
+                    keys = generateKeysSingleThreaded(keyLength, publicExponent, format);
+                } catch (...) {
+                    keys = std::nullopt;
+                }
+                onKey(std::move(keys));
+            }
+
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--runnersLeft == 0) {
+                allDone.notify_one();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    allDone.wait(lock, [&]() { return runnersLeft == 0; });
+}
+
+// Packed item layout: "RSAKP1\n<public key length>\n<public key><private key>"
+static const char kPackedKeyPairMagic[] = "RSAKP1\n";
+
+std::string RSAGenerator::packKeyPair(const KeyPair& keys) {
+    std::string packed(kPackedKeyPairMagic);
+    packed.append(std::to_string(keys.publicKey.size())).push_back('\n');
+    packed.reserve(packed.size() + keys.publicKey.size() + keys.privateKey.size());
+    packed.append(keys.publicKey);
+    packed.append(keys.privateKey);
+    return packed;
+}
+
+std::optional<KeyPair> RSAGenerator::unpackKeyPair(const std::string& packed) {
+    const size_t magicLength = sizeof(kPackedKeyPairMagic) - 1;
+    if (packed.compare(0, magicLength, kPackedKeyPairMagic) != 0) {
+        return std::nullopt;
+    }
+
+    size_t lineEnd = packed.find('\n', magicLength);
+    if (lineEnd == std::string::npos || lineEnd == magicLength) {
+        return std::nullopt;
+    }
+
+    size_t publicLength = 0;
+    for (size_t i = magicLength; i < lineEnd; i++) {
+        if (packed[i] < '0' || packed[i] > '9') {
+            return std::nullopt;
+        }
+        publicLength = publicLength * 10 + static_cast<size_t>(packed[i] - '0');
+    }
+
+    size_t publicStart = lineEnd + 1;
+    if (publicLength == 0 || publicLength >= packed.size() - publicStart) {
+        return std::nullopt;
+    }
+
+    KeyPair keys;
+    keys.publicKey = packed.substr(publicStart, publicLength);
+    keys.privateKey = packed.substr(publicStart + publicLength);
+    return keys;
+}
+
+std::optional<KeyPair> RSAGenerator::retrieveKeysFromKeyring(const std::string& serviceName, bool& failed) {
+    failed = false;
+
+    // Generated keys whose write-behind store has not finished yet
+    auto pendingKeys = WriteBehind::pending(serviceName);
+    if (pendingKeys.has_value()) {
+        return pendingKeys;
+    }
+
+    if (!Keyring::isAvailable()) {
+        return std::nullopt;
+    }
+
+    bool packed = storageLayout.load() == StorageLayout::Packed;
+    if (packed) {
+        // One round trip for both keys
+        KeyringReadResult packedKeys = Keyring::lookup(serviceName + "KeyPair", "key");
+        if (packedKeys.failed) {
+            failed = true;
+            return std::nullopt;
+        }
+        if (packedKeys.value.has_value()) {
+            auto keys = unpackKeyPair(packedKeys.value.value());
+            if (keys.has_value()) {
+                return keys;
+            }
+        }
+    }
+
+    KeyringReadResult publicKey = Keyring::lookup(serviceName + "PublicKey", "key");
+    if (publicKey.failed) {
+        failed = true;
+        return std::nullopt;
+    }
+    if (!publicKey.value.has_value()) {
+        return std::nullopt;
+    }
+    KeyringReadResult privateKey = Keyring::lookup(serviceName + "PrivateKey", "key");
+    if (privateKey.failed) {
+        failed = true;
+        return std::nullopt;
+    }
+    if (!privateKey.value.has_value()) {
+        return std::nullopt;
+    }
+
     KeyPair keys;
-    keys.publicKey = publicKey.value();
-    keys.privateKey = privateKey.value();
+    keys.publicKey = std::move(publicKey.value.value());
+    keys.privateKey = std::move(privateKey.value.value());
+
+    if (packed) {
+        // Migrate the legacy two-item layout so later reads take one round
+        // trip; the legacy items stay for readers using the split layout
+        Keyring::setPassword(serviceName + "KeyPair", "key", packKeyPair(keys));
+    }
 
     return keys;
 }
@@ -114,13 +1100,15 @@ bool RSAGenerator::storeKeysInKeyring(const KeyPair& keys, const std::string& se
         return false;
     }
 
-    std::string publicKeyService = serviceName + "PublicKey";
-    std::string privateKeyService = serviceName + "PrivateKey";
-
-    bool pubSuccess = Keyring::setPassword(publicKeyService, "key", keys.publicKey);
-    bool privSuccess = Keyring::setPassword(privateKeyService, "key", keys.privateKey);
+    // All three items are written whatever the layout, which only decides
+    // how keys are read: a rotation in a split-configured process would
+    // otherwise leave packed readers with the previous pair, and one in a
+    // packed process would leave split readers with it
+    bool packedSuccess = Keyring::setPassword(serviceName + "KeyPair", "key", packKeyPair(keys));
+    bool pubSuccess = Keyring::setPassword(serviceName + "PublicKey", "key", keys.publicKey);
+    bool privSuccess = Keyring::setPassword(serviceName + "PrivateKey", "key", keys.privateKey);
 
-    return pubSuccess && privSuccess;
+    return packedSuccess && pubSuccess && privSuccess;
 }
 
 } // namespace KeysGen
\ No newline at end of file
@@ -1,24 +1,137 @@
 #pragma once
 
+#include "cancellation.h"
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <optional>
+#include <vector>
 
 namespace KeysGen {
 
+// Encoding of exported keys. Keys are generated and stored as PKCS#1 PEM.
+enum class KeyFormat {
+    Pkcs1Pem,   // BEGIN RSA PUBLIC KEY / BEGIN RSA PRIVATE KEY
+    Pkcs8Pem,   // BEGIN PUBLIC KEY (SPKI) / BEGIN PRIVATE KEY (PKCS#8)
+    Pkcs1Der,
+    Pkcs8Der,   // SPKI / PKCS#8
+    Raw         // big-endian components, see RSAGenerator::splitRawKey
+};
+
 struct KeyPair {
     std::string publicKey;
     std::string privateKey;
+    KeyFormat format = KeyFormat::Pkcs1Pem;
+};
+
+// How a service's keys are laid out in the keyring
+enum class StorageLayout {
+    Split,   // {service}PublicKey and {service}PrivateKey items
+    Packed   // one {service}KeyPair item holding both keys
+};
+
+// Milliseconds spent by each step of RSAGenerator::warmup
+struct WarmupStats {
+    double initMs = 0;       // OPENSSL_init_crypto, config and provider loading
+    double keymgmtMs = 0;    // RSA key management fetch and keygen context
+    double encodersMs = 0;   // first PEM/DER encode and decode
+    double drbgMs = 0;       // seeding the random generators
+    double totalMs = 0;
 };
 
 class RSAGenerator {
 public:
-    static std::optional<KeyPair> generateKeys(int keyLength);
+    static constexpr unsigned long kDefaultPublicExponent = 65537;
+    static constexpr int kParallelMinKeyLength = 2048;
+    // Modulus sizes OpenSSL accepts for RSA key generation
+    static constexpr int kMinKeyLength = 512;
+    static constexpr int kMaxKeyLength = 16384;
+    static constexpr int kDefaultProcessLockTimeoutMs = 60000;
+
+    static std::optional<KeyPair> generateKeys(int keyLength, unsigned long publicExponent = kDefaultPublicExponent);
+    // Search for p and q on `threads` threads (0 = auto) for keys of at least
+    // kParallelMinKeyLength bits. Produces standard PKCS#1 keys.
+    static void setParallelKeygen(bool enabled, size_t threads);
+    static bool isParallelKeygenEnabled();
+    static size_t getParallelKeygenThreads();
+    // Give every thread that generates or converts keys its own OpenSSL
+    // library context (provider, method store, DRBGs) instead of sharing the
+    // default one
+    static void setIsolatedLibraryContexts(bool enabled);
+    // Pays OpenSSL's lazy initialization up front so the first key request
+    // runs at steady-state speed. Runs once per process; later calls
+    // return the timings of that run.
+    static WarmupStats warmup();
+    // Generates count key pairs on up to `concurrency` threads of the shared
+    // pool (0 = all of them). onKey is called from worker threads as each
+    // pair completes (nullopt on failure); returns once all have completed.
+    static void generateKeysBatch(size_t count, int keyLength, unsigned long publicExponent, size_t concurrency,
+                                  KeyFormat format, const std::function<void(std::optional<KeyPair>)>& onKey);
+    // Re-encodes a key; nullopt if it cannot be parsed. Raw keys cannot be
+    // converted from.
+    static std::optional<std::string> convertKey(const std::string& key, bool isPrivate, KeyFormat from, KeyFormat to);
+    static std::optional<KeyPair> convertKeyPair(KeyPair keys, KeyFormat format);
+    // Components of a Raw key, each stored as a 4-byte big-endian length and
+    // the big-endian value: n, e for public keys; n, e, d, p, q for private
+    // keys. Empty if the key is malformed.
+    static std::vector<std::string> splitRawKey(const std::string& key);
+    // Concurrent calls for the same serviceName share one in-flight operation
     static std::optional<KeyPair> getOrGenerateKeys(const std::string& serviceName, int keyLength);
+    // Serialize generation for a service across processes (e.g. Node cluster
+    // workers) so only one generates on a keyring miss; timeoutMs < 0 keeps
+    // the current timeout
+    static void setProcessLock(bool enabled, int timeoutMs);
+    static bool isProcessLockEnabled();
+    static int getProcessLockTimeoutMs();
+    // Generates and stores a new pair. With a cancellation, it commits after
+    // generating and returns nullopt without storing if it was cancelled.
+    static std::optional<KeyPair> regenerateKeys(const std::string& serviceName, int keyLength,
+                                                 const CancellationPtr& cancellation = nullptr);
+    static std::optional<std::string> getStoredPublicKey(const std::string& serviceName);
+    static std::optional<std::string> getStoredPrivateKey(const std::string& serviceName);
+    // Non-blocking variant of the two above. done runs on the keyring thread
+    // (or the caller for cache hits, or the cancelling thread) and must not block.
+    static void getStoredKeyAsync(const std::string& serviceName, bool privateKey,
+                                  std::function<void(std::optional<std::string>)> done,
+                                  const CancellationPtr& cancellation = nullptr);
+    // Stored keys of many services, in order, from one keyring pass (two
+    // when packed items fall back to the split layout). Blocks.
+    static std::vector<std::optional<KeyPair>> getStoredKeysBulk(const std::vector<std::string>& serviceNames);
+    // Packed halves the round trips of reads, which fall back to (and
+    // migrate) the split layout. Writes store both layouts either way.
+    static void setStorageLayout(StorageLayout layout);
+    // Deletes the service's keys (both layouts) in one keyring pass; returns
+    // the number of deleted items, -1 on failure
+    static int clearKeys(const std::string& serviceName);
+    // Deletes the keys of every service whose name starts with prefix, in
+    // one keyring search-and-delete pass
+    static int clearKeysByPrefix(const std::string& prefix);
+    // Drop the service's keys from the in-process keyring cache
+    static void invalidateCachedKeys(const std::string& serviceName);
 
 private:
-    static std::optional<KeyPair> retrieveKeysFromKeyring(const std::string& serviceName);
+    static std::optional<KeyPair> getOrGenerateKeysUncoalesced(const std::string& serviceName, int keyLength);
+    static std::optional<KeyPair> generateAndStoreKeys(const std::string& serviceName, int keyLength);
+    static std::optional<KeyPair> acquireKeys(int keyLength);
+    static std::optional<KeyPair> generateKeysSingleThreaded(int keyLength, unsigned long publicExponent,
+                                                             KeyFormat format = KeyFormat::Pkcs1Pem);
+    static std::optional<KeyPair> generateKeysParallel(int keyLength, unsigned long publicExponent, size_t threads);
+    static std::optional<KeyPair> encodeKeyPair(void* key, KeyFormat format = KeyFormat::Pkcs1Pem);
+    // nullopt with failed set when the keyring did not answer (an error, a
+    // timeout or the open breaker), which is not a miss
+    static std::optional<KeyPair> retrieveKeysFromKeyring(const std::string& serviceName, bool& failed);
+    // Reads the split layout without blocking and migrates it to a packed
+    // item; done runs where Keyring::getPasswordAsync completes
+    static void readSplitKeysAsync(const std::string& serviceName,
+                                   std::function<void(std::optional<KeyPair>)> done,
+                                   const CancellationPtr& cancellation);
     static bool storeKeysInKeyring(const KeyPair& keys, const std::string& serviceName);
-    static std::optional<std::string> rsaKeyToPem(void* key, bool isPrivate);
+    // Drops a queued write-behind store so it cannot overwrite a newer write
+    static void cancelPendingWrite(const std::string& serviceName);
+    static std::string packKeyPair(const KeyPair& keys);
+    static std::optional<KeyPair> unpackKeyPair(const std::string& packed);
+    static std::optional<std::string> encodeKey(void* key, bool isPrivate, KeyFormat format);
+    static std::optional<std::string> rsaKeyToRaw(void* key, bool isPrivate);
 };
 
 } // namespace KeysGen
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <exception>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace KeysGen {
+
+// Collapses concurrent calls for the same key into one execution: the first
+// caller runs the function, callers arriving while it is in flight wait for
+// and share its result (or exception)
+template <typename Result>
+class SingleFlight {
+public:
+    template <typename Fn>
+    Result run(const std::string& key, Fn&& fn) {
+        std::promise<Result> promise;
+        std::shared_future<Result> future;
+        bool leader = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = inFlight_.find(key);
+            if (it != inFlight_.end()) {
+                future = it->second;
+            } else {
+                future = promise.get_future().share();
+                inFlight_.emplace(key, future);
+                leader = true;
+            }
+        }
+
+        if (!leader) {
+            return future.get();
+        }
+
+        try {
+            promise.set_value(fn());
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            inFlight_.erase(key);
+        }
+
+        return future.get();
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_future<Result>> inFlight_;
+};
+
+} // namespace KeysGen
\ No newline at end of file
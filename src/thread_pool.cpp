@@ -0,0 +1,70 @@
+#include "thread_pool.h"
+#include <utility>
+
+namespace KeysGen {
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskAvailable_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    taskAvailable_.notify_one();
+}
+
+size_t ThreadPool::size() const {
+    return workers_.size();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(defaultThreadCount());
+    return pool;
+}
+
+size_t ThreadPool::defaultThreadCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskAvailable_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        task();
+    }
+}
+
+} // namespace KeysGen
\ No newline at end of file
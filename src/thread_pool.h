@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace KeysGen {
+
+// Fixed-size pool of native worker threads for CPU-bound key generation
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    size_t size() const;
+
+    // Process-wide pool sized to the number of hardware threads
+    static ThreadPool& shared();
+    static size_t defaultThreadCount();
+
+private:
+    void workerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable taskAvailable_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
+
+} // namespace KeysGen
\ No newline at end of file
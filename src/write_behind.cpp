@@ -0,0 +1,231 @@
+#include "write_behind.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace KeysGen {
+
+namespace {
+
+struct PendingWrite {
+    KeyPair keys;
+    WriteBehind::StoreFn store;
+    // Order of the first enqueue, kept when the pair is replaced so flush
+    // still waits for the service
+    uint64_t sequence = 0;
+    // Bumped on every replacement to detect one during a write
+    uint64_t generation = 0;
+    int attempts = 0;
+    std::chrono::steady_clock::time_point due;
+    bool writing = false;
+};
+
+struct WriteBehindState {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::unordered_map<std::string, PendingWrite> pending;
+    std::thread worker;
+    bool running = false;
+    bool stopping = false;
+    bool enabled = false;
+    int maxRetries = 5;
+    std::chrono::milliseconds retryDelay{ 200 };
+    uint64_t nextSequence = 0;
+    uint64_t nextGeneration = 0;
+    uint64_t persisted = 0;
+    uint64_t failed = 0;
+};
+
+WriteBehindState& state() {
+    static WriteBehindState instance;
+    return instance;
+}
+
+// Earliest due write that is not in progress
+std::unordered_map<std::string, PendingWrite>::iterator nextWrite(WriteBehindState& s) {
+    auto next = s.pending.end();
+    for (auto it = s.pending.begin(); it != s.pending.end(); ++it) {
+        if (!it->second.writing && (next == s.pending.end() || it->second.due < next->second.due)) {
+            next = it;
+        }
+    }
+    return next;
+}
+
+void workerLoop() {
+    WriteBehindState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    while (!s.stopping) {
+        auto next = nextWrite(s);
+        if (next == s.pending.end()) {
+            s.changed.wait(lock);
+            continue;
+        }
+        if (next->second.due > std::chrono::steady_clock::now()) {
+            s.changed.wait_until(lock, next->second.due);
+            continue;
+        }
+
+        std::string serviceName = next->first;
+        PendingWrite& write = next->second;
+        write.writing = true;
+        KeyPair keys = write.keys;
+        WriteBehind::StoreFn store = write.store;
+        uint64_t generation = write.generation;
+
+        lock.unlock();
+        bool stored = false;
+        try {
+            stored = store(serviceName, keys);
+        } catch (...) {
+            stored = false;
+        }
+        lock.lock();
+
+        // enqueue/cancel wait for writing to clear, so the entry is still here
+        auto it = s.pending.find(serviceName);
+        it->second.writing = false;
+        if (it->second.generation != generation) {
+            // Replaced while we wrote; the newer pair is written next
+            it->second.attempts = 0;
+        } else if (stored) {
+            s.persisted++;
+            s.pending.erase(it);
+        } else if (++it->second.attempts > s.maxRetries) {
+            s.failed++;
+            s.pending.erase(it);
+        } else {
+            it->second.due = std::chrono::steady_clock::now() + s.retryDelay * (1 << std::min(it->second.attempts - 1, 16));
+        }
+        s.changed.notify_all();
+    }
+}
+
+void ensureStarted(WriteBehindState& s) {
+    if (!s.running) {
+        s.stopping = false;
+        s.running = true;
+        s.worker = std::thread(workerLoop);
+    }
+}
+
+} // namespace
+
+void WriteBehind::configure(bool enabled, int maxRetries, int retryDelayMs) {
+    WriteBehindState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.enabled = enabled;
+    if (maxRetries >= 0) {
+        s.maxRetries = maxRetries;
+    }
+    if (retryDelayMs >= 0) {
+        s.retryDelay = std::chrono::milliseconds(retryDelayMs);
+    }
+}
+
+bool WriteBehind::enabled() {
+    WriteBehindState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.enabled;
+}
+
+void WriteBehind::enqueue(const std::string& serviceName, const KeyPair& keys, StoreFn store) {
+    WriteBehindState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+
+    auto it = s.pending.find(serviceName);
+    if (it == s.pending.end()) {
+        it = s.pending.emplace(serviceName, PendingWrite()).first;
+        it->second.sequence = ++s.nextSequence;
+    }
+    PendingWrite& write = it->second;
+    write.keys = keys;
+    write.store = std::move(store);
+    write.generation = ++s.nextGeneration;
+    write.attempts = 0;
+    write.due = std::chrono::steady_clock::now();
+
+    ensureStarted(s);
+    s.changed.notify_all();
+}
+
+std::optional<KeyPair> WriteBehind::pending(const std::string& serviceName) {
+    WriteBehindState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto it = s.pending.find(serviceName);
+    if (it == s.pending.end()) {
+        return std::nullopt;
+    }
+    return it->second.keys;
+}
+
+void WriteBehind::cancel(const std::function<bool(const std::string& serviceName)>& match) {
+    WriteBehindState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    s.changed.wait(lock, [&]() {
+        return std::none_of(s.pending.begin(), s.pending.end(), [&](const auto& item) {
+            return item.second.writing && match(item.first);
+        });
+    });
+
+    for (auto it = s.pending.begin(); it != s.pending.end();) {
+        if (match(it->first)) {
+            it = s.pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    s.changed.notify_all();
+}
+
+bool WriteBehind::flush(std::chrono::milliseconds timeout) {
+    WriteBehindState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    uint64_t target = s.nextSequence;
+    uint64_t failedBefore = s.failed;
+    auto drained = [&]() {
+        return std::none_of(s.pending.begin(), s.pending.end(),
+                            [&](const auto& item) { return item.second.sequence <= target; });
+    };
+
+    if (timeout.count() > 0) {
+        if (!s.changed.wait_for(lock, timeout, drained)) {
+            return false;
+        }
+    } else {
+        s.changed.wait(lock, drained);
+    }
+    return s.failed == failedBefore;
+}
+
+WriteBehindStats WriteBehind::getStats() {
+    WriteBehindState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    WriteBehindStats stats;
+    stats.pending = s.pending.size();
+    stats.persisted = s.persisted;
+    stats.failed = s.failed;
+    return stats;
+}
+
+void WriteBehind::shutdown(std::chrono::milliseconds timeout) {
+    flush(timeout);
+
+    WriteBehindState& s = state();
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.running) {
+            return;
+        }
+        s.stopping = true;
+        s.running = false;
+        worker = std::move(s.worker);
+        s.changed.notify_all();
+    }
+    worker.join();
+}
+
+} // namespace KeysGen
\ No newline at end of file
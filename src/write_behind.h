@@ -0,0 +1,49 @@
+#pragma once
+
+#include "rsa_generator.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace KeysGen {
+
+struct WriteBehindStats {
+    size_t pending = 0;
+    uint64_t persisted = 0;
+    uint64_t failed = 0;   // writes given up after the last retry
+};
+
+// Keyring writes of freshly generated keys, deferred so getOrGenerateKeys
+// can return as soon as keygen finishes. One background thread persists
+// them in order, retrying failures with exponential back-off; until then
+// the keys are served from memory. A newer pair for the same service
+// replaces one that has not been written yet.
+class WriteBehind {
+public:
+    using StoreFn = std::function<bool(const std::string& serviceName, const KeyPair& keys)>;
+
+    // maxRetries/retryDelayMs < 0 keep the current value
+    static void configure(bool enabled, int maxRetries, int retryDelayMs);
+    static bool enabled();
+
+    static void enqueue(const std::string& serviceName, const KeyPair& keys, StoreFn store);
+    // Keys of serviceName that are not persisted yet
+    static std::optional<KeyPair> pending(const std::string& serviceName);
+    // Drops queued writes of matching services, waiting out one in progress,
+    // so a later direct write or delete is not overwritten by a stale pair
+    static void cancel(const std::function<bool(const std::string& serviceName)>& match);
+
+    // Waits until every write queued before the call is persisted or given
+    // up (timeout 0 = no limit); true if all of them were persisted
+    static bool flush(std::chrono::milliseconds timeout);
+    static WriteBehindStats getStats();
+
+    // Flushes for up to timeout, then stops the thread (it restarts on the
+    // next enqueue); writes still queued stay queued
+    static void shutdown(std::chrono::milliseconds timeout);
+};
+
+} // namespace KeysGen
\ No newline at end of file
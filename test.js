@@ -17,6 +17,7 @@ console.log('Service name:', serviceName);
 // Test platform detection
 console.log('\nPlatform:', keysGenerator.getPlatform());
 console.log('Keychain available:', keysGenerator.isKeychainAvailable());
+console.log('OpenSSL warmup:', keysGenerator.warmup().totalMs.toFixed(1), 'ms');
 
 // Test key generation (matches original Python behavior)
 console.log('\nGenerating keys (default 2048-bit):');
@@ -73,4 +74,308 @@ if (envKeyLength) {
     }
 }
 
-console.log('\nTest completed!');
\ No newline at end of file
+// Test async variants (run off the event loop)
+(async () => {
+    console.log('\nTesting async variants:');
+    const asyncPublic = await keysGenerator.generateKeysAsync(serviceName);
+    if (asyncPublic) {
+        console.log('✅ Async key generation successful');
+        console.log('Matches stored key:', asyncPublic === keysGenerator.getPublicKey(serviceName));
+    } else {
+        console.log('❌ Async key generation failed');
+    }
+
+    const asyncPrivate = await keysGenerator.getPrivateKeyAsync(serviceName);
+    console.log(asyncPrivate ? '✅ Async private key retrieval successful' : '❌ Async private key retrieval failed');
+
+    const asyncRegenerated = await keysGenerator.regenerateKeysAsync(testServiceName, 1024);
+    if (asyncRegenerated) {
+        console.log('✅ Async regeneration successful');
+        console.log('Matches stored key:', asyncRegenerated === await keysGenerator.getPublicKeyAsync(testServiceName));
+    } else {
+        console.log('❌ Async regeneration failed');
+    }
+
+    const aborted = new AbortController();
+    aborted.abort();
+    try {
+        await keysGenerator.getPublicKeyAsync(serviceName, { signal: aborted.signal });
+        console.log('❌ Aborted lookup resolved');
+    } catch (err) {
+        console.log('✅ Aborted lookup rejected:', err.name);
+    }
+
+    // Aborted while the new pair is generated: nothing is stored
+    const rotation = new AbortController();
+    const rotating = keysGenerator.regenerateKeysAsync(testServiceName, 2048, { signal: rotation.signal });
+    rotation.abort();
+    try {
+        await rotating;
+        console.log('❌ Aborted regeneration resolved');
+    } catch (err) {
+        const kept = keysGenerator.getPublicKey(testServiceName) === asyncRegenerated;
+        console.log(kept ? '✅ Aborted regeneration stored nothing' : '❌ Aborted regeneration replaced the keys');
+    }
+
+    // Test key pool
+    console.log('\nTesting key pool (1024-bit):');
+    keysGenerator.configureKeyPool({ keyLength: 1024, lowWatermark: 1, highWatermark: 2 });
+    await new Promise(resolve => setTimeout(resolve, 1000));
+    const pooled = keysGenerator.takeKey(1024);
+    if (pooled && pooled.publicKey && pooled.privateKey) {
+        console.log('✅ Took key pair from pool');
+        console.log('Pool stats:', JSON.stringify(keysGenerator.getKeyPoolStats()));
+    } else {
+        console.log('❌ Key pool take failed');
+    }
+    keysGenerator.configureKeyPool({ keyLength: 1024, highWatermark: 0 });
+    if (keysGenerator.takeKey(1024) === null) {
+        console.log('✅ Pool miss returned null without generating');
+    } else {
+        console.log('❌ Pool miss generated a key pair');
+    }
+    try {
+        keysGenerator.takeKey(100000);
+        console.log('❌ Out-of-range takeKey length accepted');
+    } catch (err) {
+        console.log(err instanceof RangeError ? '✅ Out-of-range takeKey length rejected' : '❌ Out-of-range takeKey length threw ' + err.name);
+    }
+
+    // Test batch generation
+    console.log('\nTesting batch generation (4 x 1024-bit):');
+    let streamed = 0;
+    const batch = await keysGenerator.generateKeysBatch(4, 1024, { chunkSize: 2, onChunk: keys => { streamed += keys.length; } });
+    if (batch.count === 4 && streamed === 4) {
+        console.log('✅ Batch generation successful');
+        console.log(`Throughput: ${batch.keysPerSecond.toFixed(1)} keys/s on ${batch.threads} threads`);
+    } else {
+        console.log('❌ Batch generation failed');
+    }
+    const rejectedBatches = [[1e9, 1024], [1, 100000]].filter(([count, keyLength]) => {
+        try {
+            keysGenerator.generateKeysBatch(count, keyLength);
+            return false;
+        } catch (err) {
+            return err instanceof RangeError;
+        }
+    });
+    console.log(rejectedBatches.length === 2 ? '✅ Out-of-range batch rejected' : '❌ Out-of-range batch accepted');
+
+    // Test the in-memory backend (nothing reaches the keychain)
+    console.log('\nTesting memory keyring backend:');
+    const previousBackend = keysGenerator.getKeyringBackend();
+    keysGenerator.configure({ keyringBackend: 'memory' });
+    const memoryKey = keysGenerator.generateKeys(serviceName + '_Memory', 1024);
+    if (memoryKey && memoryKey === keysGenerator.getPublicKey(serviceName + '_Memory')) {
+        console.log('✅ Memory backend round trip successful');
+    } else {
+        console.log('❌ Memory backend round trip failed');
+    }
+    const bulk = await keysGenerator.getKeysBulk([serviceName + '_Memory', serviceName + '_Missing']);
+    if (bulk.length === 2 && bulk[0] && bulk[0].publicKey === memoryKey && bulk[1] === null) {
+        console.log('✅ Bulk read successful');
+    } else {
+        console.log('❌ Bulk read failed');
+    }
+    if (keysGenerator.clearKeys(serviceName + '_Memory') && keysGenerator.getPublicKey(serviceName + '_Memory') === null) {
+        console.log('✅ Clear keys successful');
+    } else {
+        console.log('❌ Clear keys failed');
+    }
+    keysGenerator.generateKeys(serviceName + '_Prefix1', 1024);
+    keysGenerator.generateKeys(serviceName + '_Prefix2', 1024);
+    const prefixRemoved = await keysGenerator.clearKeysByPrefixAsync(serviceName + '_Prefix');
+    // Three items per service: both single keys and the packed pair
+    if (prefixRemoved === 6 && keysGenerator.getPublicKey(serviceName + '_Prefix1') === null &&
+        keysGenerator.getPublicKey(serviceName + '_Prefix2') === null) {
+        console.log('✅ Async clear by prefix successful');
+    } else {
+        console.log('❌ Async clear by prefix failed');
+    }
+    keysGenerator.configure({ storageLayout: 'packed' });
+    const packedKey = keysGenerator.generateKeys(serviceName + '_Packed', 1024);
+    const rotatedKey = keysGenerator.regenerateKeys(serviceName + '_Packed', 1024);
+    keysGenerator.configure({ storageLayout: 'split' });
+    if (packedKey && rotatedKey && rotatedKey !== packedKey &&
+        keysGenerator.getPublicKey(serviceName + '_Packed') === rotatedKey) {
+        console.log('✅ Packed rotation visible to split readers');
+    } else {
+        console.log('❌ Packed rotation not visible to split readers');
+    }
+    const splitRotated = keysGenerator.regenerateKeys(serviceName + '_Packed', 1024);
+    keysGenerator.configure({ storageLayout: 'packed' });
+    keysGenerator.clearCache();
+    const packedReader = keysGenerator.getPublicKey(serviceName + '_Packed');
+    keysGenerator.configure({ storageLayout: 'split' });
+    if (splitRotated && splitRotated !== rotatedKey && packedReader === splitRotated) {
+        console.log('✅ Split rotation visible to packed readers');
+    } else {
+        console.log('❌ Split rotation not visible to packed readers');
+    }
+    keysGenerator.clearKeys(serviceName + '_Packed');
+    keysGenerator.configure({ writeBehind: true });
+    const deferredKey = keysGenerator.generateKeys(serviceName + '_WriteBehind', 1024);
+    if (deferredKey && await keysGenerator.flush(5000) && keysGenerator.getPublicKey(serviceName + '_WriteBehind') === deferredKey) {
+        console.log('✅ Write-behind flush successful');
+    } else {
+        console.log('❌ Write-behind flush failed');
+    }
+    keysGenerator.configure({ writeBehind: false });
+    keysGenerator.configure({ keyOutput: 'buffer' });
+    const bufferKey = keysGenerator.getPublicKey(serviceName + '_WriteBehind');
+    keysGenerator.configure({ keyOutput: 'string' });
+    if (Buffer.isBuffer(bufferKey) && bufferKey.toString('latin1') === deferredKey) {
+        console.log('✅ Buffer output successful');
+    } else {
+        console.log('❌ Buffer output failed');
+    }
+    keysGenerator.configure({ keyFormat: 'pkcs8-der' });
+    const derKey = keysGenerator.getPublicKey(serviceName + '_WriteBehind');
+    keysGenerator.configure({ keyFormat: 'pkcs1-pem' });
+    try {
+        const fromDer = require('crypto').createPublicKey({ key: derKey, format: 'der', type: 'spki' });
+        const pem = fromDer.export({ type: 'pkcs1', format: 'pem' });
+        console.log(pem === deferredKey ? '✅ DER output successful' : '❌ DER output failed');
+    } catch (err) {
+        console.log('❌ DER output failed');
+    }
+    keysGenerator.clearKeys(serviceName + '_WriteBehind');
+
+    // Test the file keystore backend (not available on Windows)
+    if (process.platform !== 'win32') {
+        console.log('\nTesting file keystore backend:');
+        const fs = require('fs');
+        const os = require('os');
+        const path = require('path');
+        const { spawn } = require('child_process');
+        const keystoreDirectory = fs.mkdtempSync(path.join(os.tmpdir(), 'rsa-keystore-'));
+        const keystorePath = path.join(keystoreDirectory, 'keystore.bin');
+        // Switching the path away and back makes the next call open the file again
+        const reopenKeystore = (file) => {
+            keysGenerator.configure({ keystorePath: file + '.other' });
+            keysGenerator.configure({ keystorePath: file });
+            keysGenerator.clearCache();
+        };
+
+        // A fixed master key keeps the test out of the OS keychain
+        process.env.KEYSTORE_MASTER_KEY = require('crypto').randomBytes(32).toString('hex');
+        keysGenerator.configure({ keyringBackend: 'file', keystorePath });
+        let fileKey = keysGenerator.generateKeys(serviceName + '_File', 1024);
+        reopenKeystore(keystorePath);
+        if (fileKey && keysGenerator.getPublicKey(serviceName + '_File') === fileKey) {
+            console.log('✅ File keystore create and reopen successful');
+        } else {
+            console.log('❌ File keystore create and reopen failed');
+        }
+
+        // Writers in other processes append to the same file concurrently
+        const writerScript = `
+            const keysGenerator = require(${JSON.stringify(path.join(__dirname, 'index.js'))});
+            keysGenerator.configure({ keyringBackend: 'file', keystorePath: process.argv[1] });
+            for (let i = 0; i < 5; i++) {
+                if (!keysGenerator.generateKeys(process.argv[2] + i, 1024)) {
+                    process.exit(1);
+                }
+            }`;
+        const writerPrefixes = [0, 1, 2].map(n => `${serviceName}_File${n}_`);
+        const writers = writerPrefixes.map(prefix => new Promise(resolve => {
+            spawn(process.execPath, ['-e', writerScript, keystorePath, prefix], { stdio: 'inherit' })
+                .on('exit', code => resolve(code === 0));
+        }));
+        const written = (await Promise.all(writers)).every(Boolean);
+        keysGenerator.clearCache();
+        const writerServices = writerPrefixes.flatMap(prefix => [0, 1, 2, 3, 4].map(i => prefix + i));
+        if (written && writerServices.every(service => keysGenerator.getPublicKey(service)) &&
+            keysGenerator.getPublicKey(serviceName + '_File') === fileKey) {
+            console.log('✅ Concurrent writers from other processes successful');
+        } else {
+            console.log('❌ Concurrent writers from other processes failed');
+        }
+
+        for (let i = 0; i < 3; i++) {
+            fileKey = keysGenerator.regenerateKeys(serviceName + '_File', 1024);
+        }
+        const compacted = await keysGenerator.compactKeystore();
+        reopenKeystore(keystorePath);
+        if (compacted && compacted.reclaimedBytes > 0 && compacted.liveBytes <= compacted.fileBytes &&
+            keysGenerator.getPublicKey(serviceName + '_File') === fileKey &&
+            writerServices.every(service => keysGenerator.getPublicKey(service))) {
+            console.log('✅ Keystore compaction successful');
+        } else {
+            console.log('❌ Keystore compaction failed');
+        }
+
+        // A store that crashed before its header reached the disk
+        const blankPath = path.join(keystoreDirectory, 'blank.bin');
+        fs.writeFileSync(blankPath, Buffer.alloc(64 * 1024));
+        keysGenerator.configure({ keystorePath: blankPath });
+        const blankKey = keysGenerator.generateKeys(serviceName + '_File', 1024);
+        reopenKeystore(blankPath);
+        if (blankKey && keysGenerator.getPublicKey(serviceName + '_File') === blankKey) {
+            console.log('✅ Keystore with an unwritten header initialized');
+        } else {
+            console.log('❌ Keystore with an unwritten header not initialized');
+        }
+
+        const magic = fs.openSync(keystorePath, 'r+');
+        fs.writeSync(magic, Buffer.from('CORRUPT!'), 0, 8, 0);
+        fs.closeSync(magic);
+        reopenKeystore(keystorePath);
+        if (keysGenerator.getPublicKey(serviceName + '_File') === null) {
+            console.log('✅ Corrupted keystore refused');
+        } else {
+            console.log('❌ Corrupted keystore read');
+        }
+
+        // Another process holding the store lock blocks the keyring thread;
+        // a timed-out read must not be taken for a missing key
+        const blockedPath = path.join(keystoreDirectory, 'blocked.bin');
+        const holder = spawn('perl', ['-e', 'use Fcntl ":flock"; open F, ">>", $ARGV[0] or die; flock F, LOCK_EX; $| = 1; print "locked\n"; sleep 30',
+            blockedPath + '.lock'], { stdio: ['ignore', 'pipe', 'ignore'] });
+        const holding = await new Promise(resolve => {
+            holder.on('error', () => resolve(false));
+            holder.stdout.once('data', () => resolve(true));
+        });
+        if (holding) {
+            keysGenerator.configure({ keystorePath: blockedPath });
+            keysGenerator.clearCache();
+            const lookup = new AbortController();
+            const blockedLookup = keysGenerator.getPublicKeyAsync(serviceName + '_Blocked', { signal: lookup.signal });
+            setTimeout(() => lookup.abort(), 50);
+            const abortedInTime = await Promise.race([
+                blockedLookup.then(() => false, err => err === lookup.signal.reason),
+                new Promise(resolve => setTimeout(() => resolve(false), 2000))
+            ]);
+            console.log(abortedInTime ? '✅ Aborted lookup on a blocked keychain rejected' : '❌ Aborted lookup on a blocked keychain still pending');
+
+            keysGenerator.configure({ keyringTimeoutMs: 200, circuitBreakerThreshold: 1, circuitBreakerCooldownMs: 60000 });
+            const timedOutKey = keysGenerator.generateKeys(serviceName + '_Blocked', 1024);
+            const started = Date.now();
+            const openKey = keysGenerator.generateKeys(serviceName + '_Blocked', 1024);
+            const failedFast = Date.now() - started < 100;
+
+            const exited = new Promise(resolve => holder.on('exit', resolve));
+            holder.kill();
+            await exited;
+            // Threshold 0 closes the breaker
+            keysGenerator.configure({ keyringTimeoutMs: 0, circuitBreakerThreshold: 0 });
+            keysGenerator.configure({ circuitBreakerThreshold: 5, circuitBreakerCooldownMs: 30000 });
+            keysGenerator.clearCache();
+            if (timedOutKey === null && openKey === null && failedFast &&
+                keysGenerator.getPublicKey(serviceName + '_Blocked') === null) {
+                console.log('✅ Keyring timeout and circuit breaker generated nothing');
+            } else {
+                console.log('❌ Keyring timeout or circuit breaker generated keys');
+            }
+        } else {
+            console.log('Skipping keyring timeout test (perl not available)');
+        }
+
+        keysGenerator.configure({ keystorePath: '' });
+        delete process.env.KEYSTORE_MASTER_KEY;
+        fs.rmSync(keystoreDirectory, { recursive: true, force: true });
+    }
+    keysGenerator.configure({ keyringBackend: previousBackend });
+
+    console.log('\nTest completed!');
+})();
\ No newline at end of file